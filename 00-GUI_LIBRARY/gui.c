@@ -62,7 +62,7 @@ uint32_t __GetNumberOfPendingWidgets(GUI_HANDLE_p parent) {
         return 1;                                   /* We have object to redraw */
     }
     for (h = __GUI_LINKEDLIST_WidgetGetNext((GUI_HANDLE_ROOT_t *)parent, 0); h; h = __GUI_LINKEDLIST_WidgetGetNext(NULL, h)) {
-        if (!__GUI_WIDGET_IsVisible(h)) {           /* Check if visible */
+        if (!__GUI_WIDGET_IsVisible(h) || __GH(h)->Overlay) {  /* Check if visible and not on overlay plane */
             continue;
         }
         if (__GUI_WIDGET_AllowChildren(h)) {        /* If this widget has children elements */
@@ -121,7 +121,9 @@ uint32_t __RedrawWidgets(GUI_HANDLE_p parent) {
         }
         __GH(parent)->Flags &= ~GUI_FLAG_REDRAW;    /* Clear flag */
         for (h = __GUI_LINKEDLIST_WidgetGetNext((GUI_HANDLE_ROOT_t *)parent, 0); h; h = __GUI_LINKEDLIST_WidgetGetNext(NULL, h)) {
-            __GH(h)->Flags |= GUI_FLAG_REDRAW;      /* Set redraw bit to all children elements */
+            if (!__GH(h)->Overlay) {                /* Overlay planes are not affected by parent */
+                __GH(h)->Flags |= GUI_FLAG_REDRAW;  /* Set redraw bit to all children elements */
+            }
         }
         if (__GUI_WIDGET_IsInsideClippingRegion(parent)) {  /* If draw function is set and drawing is inside clipping region */
             __CheckDispClipping(parent);            /* Check coordinates for drawings */
@@ -131,7 +133,7 @@ uint32_t __RedrawWidgets(GUI_HANDLE_p parent) {
 
     /* Go through all elements of parent */
     for (h = __GUI_LINKEDLIST_WidgetGetNext((GUI_HANDLE_ROOT_t *)parent, 0); h; h = __GUI_LINKEDLIST_WidgetGetNext(NULL, h)) {
-        if (!__GUI_WIDGET_IsVisible(h)) {           /* Check if visible */
+        if (!__GUI_WIDGET_IsVisible(h) || __GH(h)->Overlay) {  /* Check if visible and not on overlay plane */
             continue;                               /* Ignore hidden elements */
         }
         if (__GUI_WIDGET_AllowChildren(h)) {        /* If this widget allows children widgets */
@@ -151,6 +153,73 @@ uint32_t __RedrawWidgets(GUI_HANDLE_p parent) {
     return cnt;                                     /* Return number of redrawn objects */
 }
 
+/* Redraw widget to overlay layer and update its plane */
+static
+uint32_t __RedrawOverlayWidget(GUI_HANDLE_p h) {
+    GUI_Display_t disp;
+    GUI_Byte layer;
+    GUI_iDim_t x, y;
+    GUI_Dim_t wi, hi;
+    
+    if (!__GUI_WIDGET_IsVisible(h)) {               /* Hidden widget has hidden plane */
+        __GH(h)->Flags &= ~GUI_FLAG_REDRAW;
+        __GUI_OVERLAY_Hide(__GH(h)->Overlay);
+        return 0;
+    }
+    if (!(__GH(h)->Flags & GUI_FLAG_REDRAW)) {      /* Check if redraw required */
+        return 0;
+    }
+    
+    x = __GUI_WIDGET_GetAbsoluteX(h);
+    y = __GUI_WIDGET_GetAbsoluteY(h);
+    wi = __GUI_WIDGET_GetWidth(h);
+    hi = __GUI_WIDGET_GetHeight(h);
+    
+    /* Draw widget to overlay layer with clipping set to widget only */
+    memcpy(&disp, &GUI.Display, sizeof(disp));
+    layer = GUI.LCD.DrawingLayer;
+    GUI.LCD.DrawingLayer = GUI.LCD.OverlayLayer;
+    GUI.Display.X1 = x;
+    GUI.Display.Y1 = y;
+    GUI.Display.X2 = x + wi;
+    GUI.Display.Y2 = y + hi;
+    if (__GUI_WIDGET_AllowChildren(h)) {            /* Draw widget and all its children */
+        __RedrawWidgets(h);
+    } else {
+        __GH(h)->Flags &= ~GUI_FLAG_REDRAW;         /* Clear flag */
+        __CheckDispClipping(h);                     /* Check coordinates for drawings */
+        __GUI_WIDGET_Callback(h, GUI_WC_Draw, &GUI.DisplayTemp, NULL);  /* Draw widget */
+    }
+    GUI.LCD.DrawingLayer = layer;
+    memcpy(&GUI.Display, &disp, sizeof(disp));
+    
+    /* Update plane for new widget content */
+    __GUI_OVERLAY_SetPosition(__GH(h)->Overlay, x, y);
+    __GUI_OVERLAY_SetSize(__GH(h)->Overlay, wi, hi);
+    __GUI_OVERLAY_Invalidate(__GH(h)->Overlay);
+    __GUI_OVERLAY_Show(__GH(h)->Overlay);
+    return 1;
+}
+
+/* Redraw widgets shown on overlay planes, only desktop widgets can be on overlay */
+static
+uint32_t __RedrawOverlayWidgets(GUI_HANDLE_p parent) {
+    GUI_HANDLE_p h;
+    uint32_t cnt = 0;
+    
+    if (!GUI.Overlays.First) {                      /* No overlay planes */
+        return 0;
+    }
+    for (h = __GUI_LINKEDLIST_WidgetGetNext((GUI_HANDLE_ROOT_t *)parent, 0); h; h = __GUI_LINKEDLIST_WidgetGetNext(NULL, h)) {
+        if (__GH(h)->Overlay) {
+            cnt += __RedrawOverlayWidget(h);
+        } else if (!parent && __GUI_WIDGET_AllowChildren(h)) {  /* Check desktop children */
+            cnt += __RedrawOverlayWidgets(h);
+        }
+    }
+    return cnt;
+}
+
 #if GUI_USE_TOUCH
 PT_THREAD(__TouchEvents_Thread(__GUI_TouchData_t* ts, __GUI_TouchData_t* old, uint8_t v, GUI_WC_t* result)) {
     static volatile uint32_t Time;
@@ -321,11 +390,11 @@ GUI_Result_t GUI_Init(void) {
     if (GUI.LCD.LayersCount == 1) {
         GUI.LCD.ActiveLayer = 0;
         GUI.LCD.DrawingLayer = 0;
-        GUI.LL.Fill(&GUI.LCD, GUI.LCD.DrawingLayer, (void *)GUI.LCD.Layers[GUI.LCD.DrawingLayer].StartAddress, GUI.LCD.Width, GUI.LCD.Height, 0, 0xFFFFFFFF);
+        GUI.LL.Fill(&GUI.LCD, GUI.LCD.DrawingLayer, (void *)GUI.LCD.Layers[GUI.LCD.DrawingLayer].StartAddress, GUI.LCD.Width, GUI.LCD.Height, 0, __GUI_DRAW_ColorToLCD(0xFFFFFFFF));
     } else if (GUI.LCD.LayersCount > 1) {
         GUI.LCD.ActiveLayer = 0;
         GUI.LCD.DrawingLayer = 0;
-        GUI.LL.Fill(&GUI.LCD, GUI.LCD.DrawingLayer, (void *)GUI.LCD.Layers[GUI.LCD.DrawingLayer].StartAddress, GUI.LCD.Width, GUI.LCD.Height, 0, 0xFFFFFFFF);
+        GUI.LL.Fill(&GUI.LCD, GUI.LCD.DrawingLayer, (void *)GUI.LCD.Layers[GUI.LCD.DrawingLayer].StartAddress, GUI.LCD.Width, GUI.LCD.Height, 0, __GUI_DRAW_ColorToLCD(0xFFFFFFFF));
         GUI.LCD.DrawingLayer = 1;
     } else {
         return guiERROR;
@@ -469,9 +538,13 @@ int32_t GUI_Process(void) {
         time = TM_GENERAL_DWTCounterGetValue();
         /* Copy current status from one layer to another */
         GUI.LL.Copy(&GUI.LCD, drawing, (void *)GUI.LCD.Layers[active].StartAddress, (void *)GUI.LCD.Layers[drawing].StartAddress, GUI.LCD.Width, GUI.LCD.Height, 0, 0);
+        __GUI_DRAW_SetPending(drawing, 0, 0, GUI.LCD.Width, GUI.LCD.Height);
+        __GUI_OVERLAY_Restore(drawing);             /* Remove software planes from copied layer */
             
         /* Actually draw new screen based on setup */
         cnt = __RedrawWidgets(NULL);                /* Redraw all widgets now */
+        cnt += __RedrawOverlayWidgets(NULL);        /* Redraw overlay widgets */
+        __GUI_OVERLAY_Compose(drawing);             /* Put software planes on top of widgets */
         //__GUI_DEBUG("T: %d\r\n", TM_GENERAL_DWTCounterGetValue() - time);
         
         //GUI_DRAW_Rectangle(& GUI.Display, GUI.Display.X1, GUI.Display.Y1, GUI.Display.X2 - GUI.Display.X1, GUI.Display.Y2 - GUI.Display.Y1, GUI_COLOR_CYAN);
@@ -482,6 +555,9 @@ int32_t GUI_Process(void) {
         GUI.Display.X2 = 0x8000;
         GUI.Display.Y2 = 0x8000;
         
+        /* Wait for hardware to finish all operations on drawing layer */
+        __GUI_DRAW_WaitPending();
+        
         /* Set drawing layer as pending */
         GUI.LCD.Layers[drawing].Pending = 1;
         
@@ -493,6 +569,10 @@ int32_t GUI_Process(void) {
         /* New drawings won't be affected until confirmation from low-level is not received */
         GUI.LCD.ActiveLayer = drawing;
         GUI.LCD.DrawingLayer = active;
+    } else if (!(GUI.LCD.Flags & GUI_FLAG_LCD_WAIT_LAYER_CONFIRM)) {
+        /* Only overlay planes changed, layers swap is not required */
+        cnt = __RedrawOverlayWidgets(NULL);         /* Redraw overlay widgets */
+        __GUI_OVERLAY_Process();                    /* Update software planes on active layer */
     }
     
     return cnt;                                     /* Return number of elements updated on GUI */
@@ -508,3 +588,18 @@ void GUI_LCD_ConfirmActiveLayer(GUI_Byte layer_num) {
         GUI.LCD.Flags &= ~GUI_FLAG_LCD_WAIT_LAYER_CONFIRM;  /* Clear flag */
     }
 }
+
+GUI_Result_t GUI_LCD_SetPalette(const GUI_Color_t* palette, uint16_t size) {
+    if (GUI.LCD.PixelFormat != GUI_PixelFormat_L8 || size > 256 || (palette && !size)) {
+        return guiERROR;
+    }
+    __GUI_ENTER();                                  /* Enter GUI */
+    
+    GUI.LCD.Palette = palette;                      /* Set new palette, color conversion uses it from now on */
+    GUI.LCD.PaletteSize = palette ? size : 0;
+    __GUI_DRAW_SetPalette();                        /* Build lookup table for nearest palette color */
+    GUI_LL_Control(&GUI.LCD, GUI_LL_Command_SetPalette, NULL);  /* Load palette to hardware */
+    
+    __GUI_LEAVE();                                  /* Leave GUI */
+    return guiOK;
+}
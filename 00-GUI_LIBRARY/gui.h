@@ -161,6 +161,13 @@ extern "C" {
  */
 #define __GUI_ABS(x)                ((x) >= 0 ? (x) : -(x))
 
+/**
+ * \brief           Get number of bytes for single pixel in layer frame buffer
+ * \retval          Number of bytes per pixel
+ * \hideinitializer
+ */
+#define __GUI_LCD_PIXEL_SIZE()      (GUI.LCD.PixelFormat == GUI_PixelFormat_L8 ? 1 : (GUI.LCD.PixelFormat == GUI_PixelFormat_RGB565 ? 2 : 4))
+
 /**
  * \brief           Check if 2 rectangle objects covers each other in any way
  * \hideinitializer
@@ -224,6 +231,8 @@ typedef struct GUI_t {
     
     GUI_LinkedListRoot_t Root;              /*!< Root linked list of widgets */
     GUI_TIMER_CORE_t Timers;                /*!< Software structure management */
+    GUI_LinkedListRoot_t Overlays;          /*!< Root linked list of overlay planes */
+    GUI_OVERLAY_t* OverlayHW;               /*!< Pointer to overlay plane currently shown on hardware layer */
     
 #if GUI_USE_TOUCH || defined(DOXYGEN)
     __GUI_TouchData_t TouchOld;             /*!< Old touch data, used for event management */
@@ -239,6 +248,7 @@ extern GUI_t GUI;
 /* Include widget structure */
 #include "widgets/gui_widget.h"
 #include "input/gui_input.h"
+#include "gui_overlay.h"
 
 /**
  * \brief           Initializes GUI stack.
@@ -257,6 +267,16 @@ void GUI_UpdateTime(uint32_t millis);
 
 //Notify GUI from low-level that layer is in use
 void GUI_LCD_ConfirmActiveLayer(GUI_Byte layer_num);
+
+/**
+ * \brief           Set color palette for indexed \ref GUI_PixelFormat_L8 frame buffers
+ * \note            Call it before widgets are drawn. Colors already on screen keep their indexes
+ * \note            Palette memory must stay valid and unchanged while in use
+ * \param[in]       *palette: Pointer to list of colors. Set to NULL to use default RGB332 palette
+ * \param[in]       size: Number of colors in palette, up to 256
+ * \retval          Member of \ref GUI_Result_t enumeration
+ */
+GUI_Result_t GUI_LCD_SetPalette(const GUI_Color_t* palette, uint16_t size);
  
 /**
  * \} GUI
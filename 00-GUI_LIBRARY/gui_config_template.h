@@ -78,6 +78,25 @@
  */
 #define GUI_KEYBOARD_BUFFER_SIZE        10
 
+/**
+ * \brief           Number of anti-aliased characters kept in cache as expanded A8 masks.
+ *                    Set to 0 to disable cache
+ *
+ * \note            Cache is used only when low-level driver supports copy with blending
+ */
+#define GUI_GLYPH_CACHE_COUNT           16
+
+/**
+ * \brief           Maximal number of pixels (width * height) of single cached character.
+ *                    Larger characters are drawn without cache
+ */
+#define GUI_GLYPH_CACHE_GLYPH_SIZE      1024
+
+/**
+ * \brief           Number of nested clipping regions saved with \ref GUI_DRAW_PushClip
+ */
+#define GUI_CLIP_STACK_SIZE             4
+
 /**
  * \}
  */
@@ -73,6 +73,7 @@ extern "C" {
 #define GUI_FLAG_IGNORE_INVALIDATE      ((uint32_t)0x00004000)  /*!< Indicates widget invalidation is ignored completely when invalidating it directly */
 
 #define GUI_FLAG_LCD_WAIT_LAYER_CONFIRM ((uint32_t)0x00000001)  /*!< Indicates waiting for layer change confirmation */
+#define GUI_FLAG_LCD_DIRECT             ((uint32_t)0x00000002)  /*!< Layers are memory mapped in GUI coordinates and drawing may write directly to \ref GUI_Layer_t.StartAddress */
 
 /**
  * \}
@@ -297,16 +298,43 @@ typedef struct GUI_Layer_t {
     volatile uint8_t Pending;               /*!< Layer pending for redrawing operation */
 } GUI_Layer_t;
 
+/**
+ * \brief           LCD frame buffer pixel format enumeration
+ * \note            Colors passed to low-level drawing functions are already in this format
+ */
+typedef enum GUI_PixelFormat_t {
+    GUI_PixelFormat_ARGB8888 = 0x00,        /*!< 32-bit pixels, colors are passed as is */
+    GUI_PixelFormat_RGB565,                 /*!< 16-bit pixels without alpha channel */
+    GUI_PixelFormat_L8,                     /*!< 8-bit index to color lookup table, see \ref GUI_LCD_SetPalette */
+    GUI_PixelFormat_A8,                     /*!< 8-bit alpha mask for fixed color. Used for source data only */
+} GUI_PixelFormat_t;
+
+/**
+ * \brief           LCD rotation enumeration
+ * \note            Rotation is clockwise and is applied by low-level driver once per drawing operation
+ */
+typedef enum GUI_LCD_Rotation_t {
+    GUI_LCD_Rotation_0 = 0x00,              /*!< GUI coordinates match panel coordinates */
+    GUI_LCD_Rotation_90,                    /*!< GUI is rotated by 90 degrees, width and height are swapped */
+    GUI_LCD_Rotation_180,                   /*!< GUI is rotated by 180 degrees */
+    GUI_LCD_Rotation_270,                   /*!< GUI is rotated by 270 degrees, width and height are swapped */
+} GUI_LCD_Rotation_t;
+
 /**
  * \brief           GUI LCD structure
  */
 typedef struct GUI_LCD_t {
     GUI_Dim_t Width;                        /*!< LCD width in units of pixels */
     GUI_Dim_t Height;                       /*!< LCD height in units of pixels */
+    GUI_LCD_Rotation_t Rotation;            /*!< LCD rotation. Width and height are in rotated coordinates */
+    GUI_PixelFormat_t PixelFormat;          /*!< Pixel format of layers frame buffers */
+    const GUI_Color_t* Palette;             /*!< Color lookup table for \ref GUI_PixelFormat_L8 format. When NULL, RGB332 palette is used */
+    uint16_t PaletteSize;                   /*!< Number of colors in palette */
     GUI_Byte ActiveLayer;                   /*!< Active layer number currently shown to LCD */
     GUI_Byte DrawingLayer;                  /*!< Currently active drawing layer */
     GUI_Byte LayersCount;                   /*!< Number of layers used for LCD and drawings */
     GUI_Layer_t* Layers;                    /*!< Pointer to layers */
+    GUI_Byte OverlayLayer;                  /*!< Layer number used for overlay planes drawing. Set to 0 if overlays are not supported */
     uint32_t Flags;                         /*!< List of flags */
 } GUI_LCD_t;
 
@@ -320,15 +348,36 @@ typedef struct GUI_Display_t {
     GUI_iDim_t Y2;                          /*!< Clipping area end Y */
 } GUI_Display_t;
 
+/**
+ * \brief           Overlay plane shown on top of all widgets
+ * \sa              GUI_OVERLAY
+ */
+typedef struct GUI_OVERLAY_t {
+    GUI_LinkedList_t List;                  /*!< Linked list entry, must be first on the list */
+    GUI_iDim_t X;                           /*!< Absolute X position of plane on LCD */
+    GUI_iDim_t Y;                           /*!< Absolute Y position of plane on LCD */
+    GUI_Dim_t Width;                        /*!< Plane width in units of pixels */
+    GUI_Dim_t Height;                       /*!< Plane height in units of pixels */
+    GUI_Color_t Color;                      /*!< Plane color when \ref GUI_FLAG_OVERLAY_SOLID flag is set */
+    GUI_Byte Alpha;                         /*!< Global plane transparency, 0xFF is opaque */
+    uint8_t Flags;                          /*!< List of plane flags */
+    GUI_Display_t Shown;                    /*!< Area where plane is currently composed in software */
+    GUI_Color_t* Background;                /*!< Pointer to saved background below software composed plane */
+    uint32_t BackgroundSize;                /*!< Number of pixels allocated for background */
+} GUI_OVERLAY_t;
+
 /**
  * \brief           Low-level LCD command enumeration
  */
 typedef enum GUI_LL_Command_t {
     GUI_LL_Command_SetActiveLayer = 0x00,   /*!< Set new layer as active layer */
+    GUI_LL_Command_SetOverlay,              /*!< Show, move or hide overlay plane on hardware layer. Parameter is pointer to \ref GUI_OVERLAY_t, function must return 1 if not supported */
+    GUI_LL_Command_SetPalette,              /*!< Load \ref GUI_LCD_t.Palette to color lookup table. Parameter is not used */
 } GUI_LL_Command_t;
 
 /**
  * \brief           GUI Low-Level structure for drawing operations
+ * \note            Colors are passed to and returned from functions in \ref GUI_LCD_t.PixelFormat format
  */
 typedef struct GUI_LL_t {
     void            (*Init)         (GUI_LCD_t* LCD);                                                                           /*!< Pointer to LCD initialization function */
@@ -336,9 +385,17 @@ typedef struct GUI_LL_t {
     GUI_Color_t     (*GetPixel)     (GUI_LCD_t* LCD, uint8_t layer, GUI_Dim_t, GUI_Dim_t);                                      /*!< Pointer to read pixel from LCD */
     void            (*Fill)         (GUI_LCD_t* LCD, uint8_t layer, void *, GUI_Dim_t, GUI_Dim_t, GUI_Dim_t, GUI_Color_t);      /*!< Pointer to LCD fill screen or rectangle function */
     void            (*Copy)         (GUI_LCD_t* LCD, uint8_t layer, void *, void *, GUI_Dim_t, GUI_Dim_t, GUI_Dim_t, GUI_Dim_t);/*!< Pointer to LCD copy data from source to destination */
+    uint8_t         (*CopyConvert)  (GUI_LCD_t* LCD, uint8_t layer, const void *, void *, GUI_PixelFormat_t, GUI_Dim_t, GUI_Dim_t, GUI_Dim_t, GUI_Dim_t, GUI_Color_t, GUI_Byte, uint8_t);  /*!< Pointer to copy with source pixel format conversion and optional blending over destination.
+                                                                                                                                     Parameters after format are sizes, offsets, color for \ref GUI_PixelFormat_A8 source, global alpha and blend enable.
+                                                                                                                                     Function must return 1 if operation is not supported. Set to 0 to use software conversion */
+    void            (*WritePixels)  (GUI_LCD_t* LCD, uint8_t layer, GUI_Dim_t, GUI_Dim_t, GUI_Dim_t, GUI_Dim_t, const void *, GUI_Dim_t);  /*!< Pointer to write rectangle of pixels from memory. Parameters are X, Y, width, height, pixels in LCD format and source line offset.
+                                                                                                                                     Pixels may be read after function returns until hardware is not busy anymore. Set to 0 to write pixel by pixel */
     void            (*DrawHLine)    (GUI_LCD_t* LCD, uint8_t layer, GUI_Dim_t, GUI_Dim_t, GUI_Dim_t, GUI_Color_t);              /*!< Pointer to horizontal line drawing. Set to 0 if you do not have optimized version */
     void            (*DrawVLine)    (GUI_LCD_t* LCD, uint8_t layer, GUI_Dim_t, GUI_Dim_t, GUI_Dim_t, GUI_Color_t);              /*!< Pointer to vertical line drawing. Set to 0 if you do not have optimized version */
     void            (*FillRect)     (GUI_LCD_t* LCD, uint8_t layer, GUI_Dim_t, GUI_Dim_t, GUI_Dim_t, GUI_Dim_t, GUI_Color_t);   /*!< Pointer to function for filling rectangle on LCD */
+    uint8_t         (*BlendRect)    (GUI_LCD_t* LCD, uint8_t layer, GUI_Dim_t, GUI_Dim_t, GUI_Dim_t, GUI_Dim_t, GUI_Color_t);   /*!< Pointer to function for blending color over rectangle on LCD. Color is in ARGB8888 format and its alpha is used for blending.
+                                                                                                                                     Function must return 1 if operation is not supported. Set to 0 to use software blending */
+    uint8_t         (*IsBusy)       (GUI_LCD_t* LCD);                                                                           /*!< Pointer to function to check if hardware accelerator is still processing last operation. Set to 0 if all operations are blocking */
 } GUI_LL_t;
 
 /**
@@ -634,6 +691,42 @@ typedef struct {
 #define XXXXXXXX                        0xff
 #endif /* !defined(DOXYGEN) */
 
+/**
+ * \}
+ */
+
+/**
+ * \defgroup        GUI_IMAGE Images
+ * \brief           Image description structure and flags
+ * \{
+ */
+
+/**
+ * \brief           Image descriptor for drawing bitmaps
+ * \note            Image in \ref GUI_PixelFormat_L8 format uses \ref GUI_LCD_t.Palette as color lookup table
+ */
+typedef struct GUI_IMAGE_DESC_t {
+    GUI_Dim_t Width;                        /*!< Image width in units of pixels */
+    GUI_Dim_t Height;                       /*!< Image height in units of pixels */
+    GUI_PixelFormat_t Format;               /*!< Pixel format of image data */
+    GUI_Byte Flags;                         /*!< List of flags for image */
+    GUI_Color_t Color;                      /*!< Color of pixels for \ref GUI_PixelFormat_A8 image */
+    GUI_Color_t ColorKey;                   /*!< Raw pixel value drawn transparent when \ref GUI_FLAG_IMAGE_COLORKEY is set. Alpha is ignored for \ref GUI_PixelFormat_ARGB8888 image */
+    GUI_Const void* Data;                   /*!< Pointer to image pixels, lines are stored one after another.
+                                                With \ref GUI_FLAG_IMAGE_RLE flag each line is list of runs which do not cross line end.
+                                                Run starts with header of pixel size. When its top bit is set, next pixel is repeated,
+                                                otherwise pixels follow. Other header bits are number of pixels in run minus 1.
+                                                Pixels equal to color key are always stored as repeated runs */
+    GUI_Const uint32_t* LineIndex;          /*!< Optional offsets of every \ref GUI_IMAGE_RLE_INDEX_LINES th line in run-length encoded data in units of pixels.
+                                                Lines above drawn part are skipped with it instead of reading all run headers. Set to NULL when not used */
+} GUI_IMAGE_DESC_t;
+
+#define GUI_FLAG_IMAGE_COLORKEY         0x01/*!< Pixels equal to \ref GUI_IMAGE_DESC_t.ColorKey are not drawn */
+#define GUI_FLAG_IMAGE_OPAQUE           0x02/*!< Alpha channel of \ref GUI_PixelFormat_ARGB8888 image is ignored and image is not blended */
+#define GUI_FLAG_IMAGE_RLE              0x04/*!< Image data is run-length encoded, see \ref GUI_IMAGE_DESC_t.Data */
+
+#define GUI_IMAGE_RLE_INDEX_LINES       16  /*!< Number of lines between entries of \ref GUI_IMAGE_DESC_t.LineIndex */
+
 /**
  * \}
  */
@@ -937,6 +1030,7 @@ typedef struct GUI_HANDLE {
     uint32_t TextMemSize;                   /*!< Number of bytes for text when dynamically allocated */
     uint32_t TextCursor;                    /*!< Text cursor position */
     GUI_TIMER_t* Timer;                     /*!< Software timer pointer */
+    GUI_OVERLAY_t* Overlay;                 /*!< Overlay plane pointer when widget is shown on top of all others */
     GUI_Color_t* Colors;                    /*!< Pointer to allocated color memory when used */
     void* UserData;                         /*!< Pointer to optional user data */
 } GUI_HANDLE;
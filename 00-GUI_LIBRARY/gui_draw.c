@@ -37,18 +37,496 @@
 /***                           Private definitions                           **/
 /******************************************************************************/
 /******************************************************************************/
+static
+void __SetPixel_LCD(const GUI_Display_t* disp, GUI_iDim_t x, GUI_iDim_t y, GUI_Color_t color);
+static
+void __HLine_LCD(const GUI_Display_t* disp, GUI_iDim_t x, GUI_iDim_t y, GUI_iDim_t length, GUI_Color_t color);
+
+/* Color conversion between ARGB8888 and RGB565 */
+#define __RGB565_FROM_ARGB(c)       ((((c) >> 8) & 0xF800) | (((c) >> 5) & 0x07E0) | (((c) >> 3) & 0x001F))
+#define __ARGB_FROM_RGB565(c)       (0xFF000000UL | \
+                                        (uint32_t)(((((c) >> 11) & 0x1F) << 3) | ((((c) >> 11) & 0x1F) >> 2)) << 16 | \
+                                        (uint32_t)(((((c) >>  5) & 0x3F) << 2) | ((((c) >>  5) & 0x3F) >> 4)) <<  8 | \
+                                        (uint32_t)(((((c) >>  0) & 0x1F) << 3) | ((((c) >>  0) & 0x1F) >> 2)))
+
+/* Expand color of default RGB332 palette to ARGB8888 */
+#define __ARGB_FROM_RGB332(c)       (0xFF000000UL | \
+                                        (uint32_t)((((c) >> 5) & 0x07) * 0xFF / 0x07) << 16 | \
+                                        (uint32_t)((((c) >> 2) & 0x07) * 0xFF / 0x07) <<  8 | \
+                                        (uint32_t)((((c) >> 0) & 0x03) * 0xFF / 0x03))
+
+/* Conversion used by blend kernels, pixels are read and written in LCD format */
+#define __FROM_LCD_ARGB8888(c)      (c)
+#define __TO_LCD_ARGB8888(c)        (c)
+#define __FROM_LCD_RGB565(c)        __ARGB_FROM_RGB565(c)
+#define __TO_LCD_RGB565(c)          __RGB565_FROM_ARGB(c)
+#define __FROM_LCD_L8(c)            __GUI_DRAW_ColorFromLCD(c)
+#define __TO_LCD_L8(c)              __GUI_DRAW_ColorToLCD(c)
+
+/**
+ * Kernels for direct frame buffer access, generated once per pixel format.
+ * They work on single line of memory and do not check clipping or pending hardware operations.
+ *
+ * SolidSpan:   Write "len" pixels with color in LCD format
+ * MaskSpan:    Write color for each bit set in mask, bit "offset" (MSB first) is first pixel
+ * CopySpan:    Copy "len" pixels of the same format
+ * BlendSpan:   Blend ARGB8888 color with "alpha" over "len" pixels, result is reused while background repeats
+ * GetPixel:    Read single pixel in LCD format
+ */
+#define __DRAW_KERNELS(name, type)                                                  \
+static                                                                              \
+void __SolidSpan_##name(void* dst, GUI_iDim_t len, GUI_Color_t color) {             \
+    type* d = (type *)dst;                                                          \
+    while (len-- > 0) {                                                             \
+        *d++ = (type)color;                                                         \
+    }                                                                               \
+}                                                                                   \
+static                                                                              \
+void __MaskSpan_##name(void* dst, const uint8_t* mask, GUI_iDim_t offset, GUI_iDim_t len, GUI_Color_t color) {  \
+    type* d = (type *)dst;                                                          \
+    for (; len > 0; len--, offset++, d++) {                                         \
+        if (mask[offset >> 3] & (0x80 >> (offset & 0x07))) {                        \
+            *d = (type)color;                                                       \
+        }                                                                           \
+    }                                                                               \
+}                                                                                   \
+static                                                                              \
+void __CopySpan_##name(void* dst, const void* src, GUI_iDim_t len) {                \
+    memcpy(dst, src, len * sizeof(type));                                           \
+}                                                                                   \
+static                                                                              \
+void __BlendSpan_##name(void* dst, GUI_iDim_t len, GUI_Color_t color, GUI_Byte alpha) { \
+    type* d = (type *)dst;                                                          \
+    type last = 0, res = 0;                                                         \
+    uint32_t na = 255 - alpha, bg;                                                  \
+    uint32_t r = ((color >> 16) & 0xFF) * alpha;    /* Premultiply color once */    \
+    uint32_t g = ((color >>  8) & 0xFF) * alpha;                                    \
+    uint32_t b = ((color >>  0) & 0xFF) * alpha;                                    \
+    for (; len > 0; len--, d++) {                                                   \
+        if (d == (type *)dst || *d != last) {       /* Background changed */        \
+            last = *d;                                                              \
+            bg = __FROM_LCD_##name(last);                                           \
+            res = (type)__TO_LCD_##name(                                            \
+                (bg & 0xFF000000UL) |                                               \
+                ((r + ((bg >> 16) & 0xFF) * na) / 255) << 16 |                      \
+                ((g + ((bg >>  8) & 0xFF) * na) / 255) << 8 |                       \
+                ((b + ((bg >>  0) & 0xFF) * na) / 255)                              \
+            );                                                                      \
+        }                                                                           \
+        *d = res;                                                                   \
+    }                                                                               \
+}                                                                                   \
+static                                                                              \
+GUI_Color_t __GetPixel_##name(const void* src) {                                    \
+    return *(const type *)src;                                                      \
+}
+
+/* Set of kernels for single pixel format */
+typedef struct __DRAW_Kernels_t {
+    void (*SolidSpan)(void* dst, GUI_iDim_t len, GUI_Color_t color);
+    void (*MaskSpan)(void* dst, const uint8_t* mask, GUI_iDim_t offset, GUI_iDim_t len, GUI_Color_t color);
+    void (*CopySpan)(void* dst, const void* src, GUI_iDim_t len);
+    void (*BlendSpan)(void* dst, GUI_iDim_t len, GUI_Color_t color, GUI_Byte alpha);
+    GUI_Color_t (*GetPixel)(const void* src);
+} __DRAW_Kernels_t;
+
+#define __DRAW_KERNELS_ENTRY(name)  {__SolidSpan_##name, __MaskSpan_##name, __CopySpan_##name, __BlendSpan_##name, __GetPixel_##name}
+
+/* Size of single A8 mask buffer for AA characters in units of pixels */
+#define __MASK_SIZE                 1024
+
+/* Size of single line buffer for converted pixels in units of pixels */
+#define __ROW_SIZE                  256
+
+/* Number of polygon edges processed without memory allocation */
+#define __POLY_EDGES                16
+
+/* Polygon edge for scanline fill, crossing of current scanline is at X + Rem / Den pixels left of first pixel center */
+typedef struct __PolyEdge_t {
+    GUI_iDim_t Y1;                                  /*!< Next scanline to process */
+    GUI_iDim_t Y2;                                  /*!< Scanline after last one crossing edge */
+    int32_t X;                                      /*!< Integer part of crossing position */
+    int32_t Rem;                                    /*!< Remainder of crossing position, first pixel inside is X + 1 when not 0 */
+    int32_t Den;                                    /*!< Denominator of crossing position */
+    int32_t StepX;                                  /*!< Integer part of crossing change per scanline */
+    int32_t StepRem;                                /*!< Remainder of crossing change per scanline */
+    int8_t Dir;                                     /*!< Winding direction, 1 for edge going down */
+} __PolyEdge_t;
+
+/* Number of circle line extents calculated without memory allocation */
+#define __CIRCLE_EXTENTS            128
+
+/* Rectangle collected from equal spans on consecutive lines */
+typedef struct __SpanRect_t {
+    GUI_iDim_t X;                                   /*!< Left position of spans */
+    GUI_iDim_t Y;                                   /*!< Top line */
+    GUI_iDim_t Width;                               /*!< Width of spans */
+    GUI_iDim_t Height;                              /*!< Number of collected lines */
+    uint8_t Blend;                                  /*!< Set to 1 when color is ARGB8888 and is blended over background */
+} __SpanRect_t;
+
+/* Gradient color stepping, channels are red, green and blue in 16.16 fixed-point format */
+typedef struct __Gradient_t {
+    int32_t Color[3];                               /*!< Color at position 0 */
+    int32_t Step[3];                                /*!< Color change for each position */
+} __Gradient_t;
+
+#if GUI_GLYPH_CACHE_COUNT
+/* Cached character expanded to A8 mask */
+typedef struct __GlyphCacheEntry_t {
+    const GUI_FONT_t* Font;                         /*!< Font of character, NULL when entry is empty */
+    const GUI_FONT_CharInfo_t* Char;                /*!< Character in font, identifies character code */
+    uint32_t Time;                                  /*!< Value of access counter on last use */
+    uint8_t Mask[GUI_GLYPH_CACHE_GLYPH_SIZE];       /*!< Character mask */
+} __GlyphCacheEntry_t;
+#endif /* GUI_GLYPH_CACHE_COUNT */
+
+/* Check if drawing layer may be accessed directly */
+#define __IsDirect()                (GUI.LCD.Flags & GUI_FLAG_LCD_DIRECT)
+
+/* Check if clipping region is empty and nothing can be drawn */
+#define __IsClipEmpty(disp)         ((disp)->X1 >= (disp)->X2 || (disp)->Y1 >= (disp)->Y2)
+
+/* Get kernels for current pixel format */
+#define __Kernels()                 (&Kernels[GUI.LCD.PixelFormat])
+
+/* Get memory address of pixel on layer or drawing layer */
+#define __LayerPixelAddress(layer, x, y)    (void *)(GUI.LCD.Layers[(layer)].StartAddress + __GUI_LCD_PIXEL_SIZE() * ((uint32_t)GUI.LCD.Width * (y) + (x)))
+#define __PixelAddress(x, y)        __LayerPixelAddress(GUI.LCD.DrawingLayer, x, y)
+
+__DRAW_KERNELS(ARGB8888, uint32_t)
+__DRAW_KERNELS(RGB565, uint16_t)
+__DRAW_KERNELS(L8, uint8_t)
 
 /******************************************************************************/
 /******************************************************************************/
 /***                            Private variables                            **/
 /******************************************************************************/
 /******************************************************************************/
+static GUI_Display_t PendingArea;                  /* Destination area of last started hardware operation */
+static GUI_Byte PendingLayer;                       /* Layer number for pending hardware operation */
+static uint8_t PendingValid;                        /* Set to 1 when hardware operation may still be in progress */
+static GUI_Byte* PaletteLookup;                     /* Nearest palette index for each RGB444 color, built when palette is set */
+static GUI_Byte* PaletteShared;                     /* Bit for each RGB444 color shared by more palette colors */
+
+/* Background weight in units of 1/256 for each 2-bit coverage level of AA font */
+static const uint16_t AAWeights[] = {256, 85, 171, 0};
+
+/* Font color alpha for each 2-bit coverage level of AA font, levels match AAWeights */
+static const uint8_t AAMask[] = {0x00, 0xAA, 0x55, 0xFF};
+
+static uint8_t Masks[2][__MASK_SIZE];               /* Buffers for characters expanded to A8 mask */
+static uint8_t MaskIndex;                           /* Index of next mask buffer to use */
+
+static __PolyEdge_t PolyEdges[__POLY_EDGES];        /* Edges of polygon to fill */
+static __PolyEdge_t* PolyActive[__POLY_EDGES];      /* Edges crossing current scanline */
+
+static uint32_t Rows[2][__ROW_SIZE];                /* Buffers for converted pixels in LCD format, word aligned for all formats */
+static uint8_t RowIndex;                            /* Index of next line buffer to use */
+
+static GUI_iDim_t CircleExtents[__CIRCLE_EXTENTS + 1];  /* Width of circle corner for each line */
+
+static GUI_Display_t ClipStack[GUI_CLIP_STACK_SIZE];   /* Clipping regions saved by push operation */
+static uint8_t ClipDepth;                           /* Number of push operations without pop */
+
+/* 4x4 ordered dither thresholds in range 0 to 15 */
+static const uint8_t DitherMatrix[4][4] = {
+    { 0,  8,  2, 10},
+    {12,  4, 14,  6},
+    { 3, 11,  1,  9},
+    {15,  7, 13,  5},
+};
+
+/* Sine of angles from 0 to 90 degrees in Q14 format */
+static const int16_t SinTable[91] = {
+        0,   286,   572,   857,  1143,  1428,  1713,  1997,  2280,  2563,
+     2845,  3126,  3406,  3686,  3964,  4240,  4516,  4790,  5063,  5334,
+     5604,  5872,  6138,  6402,  6664,  6924,  7182,  7438,  7692,  7943,
+     8192,  8438,  8682,  8923,  9162,  9397,  9630,  9860, 10087, 10311,
+    10531, 10749, 10963, 11174, 11381, 11585, 11786, 11982, 12176, 12365,
+    12551, 12733, 12911, 13085, 13255, 13421, 13583, 13741, 13894, 14044,
+    14189, 14330, 14466, 14598, 14726, 14849, 14968, 15082, 15191, 15296,
+    15396, 15491, 15582, 15668, 15749, 15826, 15897, 15964, 16026, 16083,
+    16135, 16182, 16225, 16262, 16294, 16322, 16344, 16362, 16374, 16382,
+    16384,
+};
+
+#if GUI_GLYPH_CACHE_COUNT
+static __GlyphCacheEntry_t GlyphCache[GUI_GLYPH_CACHE_COUNT];   /* Cache of expanded AA characters */
+static uint32_t GlyphCacheTime;                     /* Access counter for least recently used entry */
+#endif /* GUI_GLYPH_CACHE_COUNT */
+static uint32_t GlyphCacheHits;                     /* Number of characters drawn from cache */
+static uint32_t GlyphCacheMisses;                   /* Number of characters expanded to cache */
+
+/* Kernels in order of GUI_PixelFormat_t enumeration */
+static const __DRAW_Kernels_t Kernels[] = {
+    __DRAW_KERNELS_ENTRY(ARGB8888),
+    __DRAW_KERNELS_ENTRY(RGB565),
+    __DRAW_KERNELS_ENTRY(L8),
+};
 
 /******************************************************************************/
 /******************************************************************************/
 /***                            Private functions                            **/
 /******************************************************************************/
 /******************************************************************************/
+/* Get number of bytes for single pixel of source data */
+static
+uint8_t __FormatPixelSize(GUI_PixelFormat_t format) {
+    switch (format) {
+        case GUI_PixelFormat_RGB565:
+            return 2;
+        case GUI_PixelFormat_L8:
+        case GUI_PixelFormat_A8:
+            return 1;
+        default:
+            return 4;
+    }
+}
+
+/* Read single pixel of source data and return it in ARGB8888 format */
+static
+GUI_Color_t __ReadSourcePixel(const uint8_t* src, GUI_PixelFormat_t format, GUI_Color_t color) {
+    switch (format) {
+        case GUI_PixelFormat_RGB565:
+            return __ARGB_FROM_RGB565(*(const uint16_t *)src);
+        case GUI_PixelFormat_L8:
+            if (GUI.LCD.Palette) {                  /* Use LCD palette as color lookup table */
+                return *src < GUI.LCD.PaletteSize ? GUI.LCD.Palette[*src] : GUI_COLOR_BLACK;
+            }
+            return __ARGB_FROM_RGB332(*src);
+        case GUI_PixelFormat_A8:
+            return (color & 0x00FFFFFFUL) | (uint32_t)*src << 24;   /* Mask value is alpha of fixed color */
+        default:
+            return *(const uint32_t *)src;
+    }
+}
+
+/* Divide with result rounded towards negative infinity and non-negative remainder */
+static
+void __FloorDiv(int32_t num, int32_t den, int32_t* q, int32_t* r) {
+    *q = num / den;
+    *r = num % den;
+    if (*r < 0) {
+        (*q)--;
+        *r += den;
+    }
+}
+
+/* Set up polygon edge for first scanline "y" it crosses, scanlines are sampled at pixel centers */
+/* Edge crosses center of scanline at x0 + (2 * (y - y0) + 1) * dx / (2 * dy), first pixel with center right of it is stored */
+static
+void __PolyEdgeInit(__PolyEdge_t* e, GUI_iDim_t x0, GUI_iDim_t y0, GUI_iDim_t x1, GUI_iDim_t y1, GUI_iDim_t y) {
+    int32_t dx, dy;
+    int64_t num;
+    
+    e->Dir = 1;
+    if (y1 < y0) {                                  /* Process edge from top to bottom */
+        GUI_iDim_t tmp;
+        tmp = x0, x0 = x1, x1 = tmp;
+        tmp = y0, y0 = y1, y1 = tmp;
+        e->Dir = -1;
+    }
+    dx = x1 - x0;
+    dy = y1 - y0;
+    e->Y1 = y;
+    e->Y2 = y1;
+    e->Den = 2 * dy;
+    num = (int64_t)(2 * (y - y0) + 1) * dx - dy;    /* Does not fit 32 bits for long edges */
+    e->X = (int32_t)(num / e->Den);
+    e->Rem = (int32_t)(num % e->Den);
+    if (e->Rem < 0) {                               /* Round towards negative infinity */
+        e->X--;
+        e->Rem += e->Den;
+    }
+    e->X += x0;
+    __FloorDiv(2 * dx, e->Den, &e->StepX, &e->StepRem);
+}
+
+/* Get range of offsets from start coordinate along direction "inc" for which line coordinate is inside [min, max) */
+static
+void __LineAxisRange(GUI_iDim_t start, GUI_iDim_t inc, GUI_iDim_t min, GUI_iDim_t max, int32_t* lo, int32_t* hi) {
+    if (inc > 0) {
+        *lo = (int32_t)min - start;
+        *hi = (int32_t)max - 1 - start;
+    } else {
+        *lo = (int32_t)start - (max - 1);
+        *hi = (int32_t)start - min;
+    }
+}
+
+/* Get integer square root rounded down */
+static
+uint32_t __Sqrt(uint32_t x) {
+    uint32_t res = 0, bit = 1UL << 30;
+    
+    while (bit > x) {
+        bit >>= 2;
+    }
+    for (; bit; bit >>= 2) {
+        if (x >= res + bit) {
+            x -= res + bit;
+            res = (res >> 1) + bit;
+        } else {
+            res >>= 1;
+        }
+    }
+    return res;
+}
+
+/* Get sine of angle in degrees in Q14 format from quarter wave table */
+static
+int32_t __Sin(int32_t angle) {
+    angle %= 360;
+    if (angle < 0) {
+        angle += 360;
+    }
+    if (angle <= 90) {
+        return SinTable[angle];
+    } else if (angle <= 180) {
+        return SinTable[180 - angle];
+    } else if (angle <= 270) {
+        return -SinTable[angle - 180];
+    }
+    return -SinTable[360 - angle];
+}
+
+/* Get range of positions x on line y where point (x, y) is in angle range [0, 180) from direction (vx, vy) */
+/* Point is after direction when cross product is positive or point lies on ray of direction, center point is never included */
+static
+void __HalfPlane(int32_t vx, int32_t vy, int32_t y, GUI_iDim_t* lo, GUI_iDim_t* hi) {
+    int32_t q, rem;
+    
+    *lo = -0x7FFF;
+    *hi = 0x7FFF;
+    if (vy > 0) {                                   /* x < vx * y / vy */
+        __FloorDiv(vx * y, vy, &q, &rem);
+        if (!rem && y <= 0) {                       /* Point on line but not on ray */
+            q--;
+        }
+        *hi = __GUI_MAX(__GUI_MIN(q, 0x7FFF), -0x7FFF);
+    } else if (vy < 0) {                            /* x > vx * y / vy */
+        __FloorDiv(-vx * y, -vy, &q, &rem);
+        if (rem || y >= 0) {                        /* Point on ray is included */
+            q++;
+        }
+        *lo = __GUI_MAX(__GUI_MIN(q, 0x7FFF), -0x7FFF);
+    } else if (y) {                                 /* Horizontal direction, complete line is on one side */
+        if ((vx > 0) != (y > 0)) {
+            *lo = 1;
+            *hi = 0;
+        }
+    } else if (vx > 0) {                            /* Line of horizontal ray */
+        *lo = 1;
+    } else {
+        *hi = -1;
+    }
+}
+
+/* Set up gradient stepping from start to stop color in "steps" positions */
+static
+void __GradientInit(__Gradient_t* g, GUI_Color_t start, GUI_Color_t stop, int32_t steps) {
+    uint8_t i;
+    int32_t c1, c2;
+    
+    steps = __GUI_MAX(steps, 1);
+    for (i = 0; i < 3; i++) {
+        c1 = (start >> (16 - 8 * i)) & 0xFF;
+        c2 = (stop >> (16 - 8 * i)) & 0xFF;
+        g->Color[i] = (c1 << 16) + 0x8000;          /* Add half for rounding */
+        g->Step[i] = (c2 - c1) * 0x10000 / steps;
+    }
+}
+
+/* Get opaque color from fixed-point channels, dither threshold is added before conversion to RGB565 */
+static
+GUI_Color_t __GradientColor(const int32_t* c, GUI_iDim_t x, GUI_iDim_t y, uint8_t dither) {
+    GUI_Color_t color = 0xFF000000UL;
+    int32_t v, d = dither ? DitherMatrix[y & 0x03][x & 0x03] : 0;
+    uint8_t i;
+    
+    for (i = 0; i < 3; i++) {
+        v = (c[i] >> 16) + (i == 1 ? d >> 2 : d >> 1); /* Green has 6 bits, red and blue 5 bits */
+        color |= (GUI_Color_t)__GUI_MIN(__GUI_MAX(v, 0), 0xFF) << (16 - 8 * i);
+    }
+    return color;
+}
+
+/* Clip rectangle to drawing area, function returns 0 when nothing is visible */
+static
+uint8_t __ClipRect(const GUI_Display_t* disp, GUI_iDim_t* x, GUI_iDim_t* y, GUI_iDim_t* width, GUI_iDim_t* height) {
+    if (*x < disp->X1) {
+        *width -= disp->X1 - *x;
+        *x = disp->X1;
+    }
+    if (*y < disp->Y1) {
+        *height -= disp->Y1 - *y;
+        *y = disp->Y1;
+    }
+    if ((*x + *width) > disp->X2) {
+        *width = disp->X2 - *x;
+    }
+    if ((*y + *height) > disp->Y2) {
+        *height = disp->Y2 - *y;
+    }
+    return *width > 0 && *height > 0;
+}
+
+/* Wait for pending hardware operation only if it writes to area we want to access */
+static
+void __WaitPendingArea(GUI_iDim_t x1, GUI_iDim_t y1, GUI_iDim_t x2, GUI_iDim_t y2) {
+    if (PendingValid && PendingLayer == GUI.LCD.DrawingLayer && __GUI_RECT_MATCH(
+        PendingArea.X1, PendingArea.Y1, PendingArea.X2, PendingArea.Y2,
+        x1, y1, x2, y2
+    )) {
+        __GUI_DRAW_WaitPending();                   /* Wait for operation to finish */
+    }
+}
+
+/* Search palette for color with smallest distance */
+static
+GUI_Byte __PaletteSearch(const GUI_Color_t* pal, uint16_t count, GUI_Color_t color) {
+    uint32_t dist, best = 0xFFFFFFFF;
+    int32_t dr, dg, db;
+    uint16_t i;
+    GUI_Byte index = 0;
+    
+    for (i = 0; i < count; i++) {
+        dr = (int32_t)((pal[i] >> 16) & 0xFF) - (int32_t)((color >> 16) & 0xFF);
+        dg = (int32_t)((pal[i] >>  8) & 0xFF) - (int32_t)((color >>  8) & 0xFF);
+        db = (int32_t)((pal[i] >>  0) & 0xFF) - (int32_t)((color >>  0) & 0xFF);
+        dist = dr * dr + dg * dg + db * db;
+        if (dist < best) {
+            best = dist;
+            index = i;
+            if (!dist) {                            /* Exact match */
+                break;
+            }
+        }
+    }
+    return index;
+}
+
+/* Get index of nearest palette color, lookup table is indexed with RGB444 color */
+/* Colors in cells shared by more palette colors are searched unless they match table entry */
+static
+GUI_Byte __PaletteIndex(GUI_Color_t color) {
+    uint16_t cell;
+    GUI_Byte index;
+    
+    if (!GUI.LCD.Palette) {                         /* Default RGB332 palette */
+        return ((color >> 16) & 0xE0) | ((color >> 11) & 0x1C) | ((color >> 6) & 0x03);
+    }
+    if (PaletteLookup) {
+        cell = ((color >> 12) & 0xF00) | ((color >> 8) & 0x0F0) | ((color >> 4) & 0x00F);
+        index = PaletteLookup[cell];
+        if (!(PaletteShared[cell >> 3] & (1 << (cell & 0x07))) || !((GUI.LCD.Palette[index] ^ color) & 0x00FFFFFFUL)) {
+            return index;
+        }
+    }
+    return __PaletteSearch(GUI.LCD.Palette, GUI.LCD.PaletteSize, color);   /* No memory for lookup table */
+}
+
 static
 const GUI_FONT_CharInfo_t* __StringGetCharPtr(const GUI_FONT_t* font, uint32_t ch) {
     if (ch >= font->StartChar && ch <= font->EndChar) { /* Character is in font structure */
@@ -142,25 +620,294 @@ uint16_t __StringRectangle(const GUI_FONT_t* font, const GUI_Char* str, const GU
     return cnt;                                     /* Return number of characters processed */
 }
 
+/* Blend AA font color over background with fixed-point weights */
+/* Red and blue channels are processed with single multiply as they do not overlap in 32-bit word */
+static
+GUI_Color_t __BlendAA(GUI_Color_t bg, GUI_Color_t fg, GUI_Byte level) {
+    uint32_t wb = AAWeights[level], wf = 256 - wb, rb, g;
+    
+    rb = (((bg & 0x00FF00FFUL) * wb + (fg & 0x00FF00FFUL) * wf) >> 8) & 0x00FF00FFUL;
+    g  = (((bg & 0x0000FF00UL) * wb + (fg & 0x0000FF00UL) * wf) >> 8) & 0x0000FF00UL;
+    return (bg & 0xFF000000UL) | rb | g;
+}
+
+/* Expand lines of AA character to A8 mask, 4 pixels are stored in each byte */
+static
+void __ExpandCharMask(uint8_t* mask, const GUI_Byte* data, uint32_t count) {
+    for (; count; count--, data++, mask += 4) {
+        mask[0] = AAMask[(*data >> 6) & 0x03];
+        mask[1] = AAMask[(*data >> 4) & 0x03];
+        mask[2] = AAMask[(*data >> 2) & 0x03];
+        mask[3] = AAMask[(*data >> 0) & 0x03];
+    }
+}
+
+#if GUI_GLYPH_CACHE_COUNT
+/* Get expanded mask of character from cache, character is expanded to least recently used entry on miss */
+/* Entry used by last hardware operation is the most recently used one and is evicted only with single entry cache */
+static
+const uint8_t* __GetCachedCharMask(const GUI_FONT_t* font, const GUI_FONT_CharInfo_t* c, GUI_Byte columns) {
+    __GlyphCacheEntry_t* entry = &GlyphCache[0];
+    uint16_t i;
+    
+    for (i = 0; i < GUI_GLYPH_CACHE_COUNT; i++) {
+        if (GlyphCache[i].Font == font && GlyphCache[i].Char == c) {    /* Character is in cache */
+            GlyphCache[i].Time = ++GlyphCacheTime;
+            GlyphCacheHits++;
+            return GlyphCache[i].Mask;
+        }
+        if (GlyphCache[i].Time < entry->Time) {     /* Find least recently used entry */
+            entry = &GlyphCache[i];
+        }
+    }
+    
+    if (entry->Time && entry->Time == GlyphCacheTime) { /* Entry may still be read by hardware */
+        __GUI_DRAW_WaitPending();
+    }
+    __ExpandCharMask(entry->Mask, c->Data, (uint32_t)columns * c->ySize);
+    entry->Font = font;
+    entry->Char = c;
+    entry->Time = ++GlyphCacheTime;
+    GlyphCacheMisses++;
+    return entry->Mask;
+}
+#endif /* GUI_GLYPH_CACHE_COUNT */
+
+/* Expand AA character to A8 mask and blend it with font colors through low-level copy */
+/* Character is processed in bands of lines when it does not fit to mask buffer */
+static
+void __DrawCharMask(const GUI_Display_t* disp, const GUI_FONT_t* font, GUI_DRAW_FONT_t* draw, GUI_iDim_t x, GUI_iDim_t y, GUI_Byte columns, const GUI_FONT_CharInfo_t* c) {
+    GUI_Display_t clip1, clip2;
+    GUI_iDim_t width = columns * 4, lines, line, split;
+    const uint8_t* mask;
+    uint8_t started;
+    
+    if (!width) {                                   /* Character has no pixels */
+        return;
+    }
+    
+    /* Clipping for both colors, split is first pixel with second color */
+    split = draw->X + draw->Color1Width;
+    clip1 = *disp;
+    if (clip1.Y2 > draw->Y + draw->Height) {
+        clip1.Y2 = draw->Y + draw->Height;
+    }
+    clip2 = clip1;
+    clip1.X2 = __GUI_MIN(clip1.X2, split);
+    clip2.X1 = __GUI_MAX(clip2.X1, split);
+    
+    if (y >= clip1.Y2 || y + c->ySize <= clip1.Y1) {
+        return;                                     /* Character is not visible */
+    }
+    
+#if GUI_GLYPH_CACHE_COUNT
+    if ((uint32_t)width * c->ySize <= GUI_GLYPH_CACHE_GLYPH_SIZE) { /* Draw complete character from cache */
+        mask = __GetCachedCharMask(font, c, columns);
+        if (clip1.X1 < clip1.X2) {
+            __GUI_DRAW_CopyConvert(&clip1, x, y, width, c->ySize, mask, GUI_PixelFormat_A8, 0, draw->Color1, 0xFF, 1);
+        }
+        if (clip2.X1 < clip2.X2) {
+            __GUI_DRAW_CopyConvert(&clip2, x, y, width, c->ySize, mask, GUI_PixelFormat_A8, 0, draw->Color2, 0xFF, 1);
+        }
+        return;
+    }
+#endif /* GUI_GLYPH_CACHE_COUNT */
+    
+    lines = __MASK_SIZE / width;                    /* Number of lines in single band */
+    for (line = 0; line < c->ySize; line += lines) {
+        if (lines > c->ySize - line) {
+            lines = c->ySize - line;
+        }
+        if (y + line >= clip1.Y2 || y + line + lines <= clip1.Y1) {
+            continue;                               /* Band is not visible */
+        }
+        
+        /* Use buffers alternately, hardware finishes previous operation before it starts new one */
+        __ExpandCharMask(Masks[MaskIndex], &c->Data[line * columns], (uint32_t)lines * columns);
+        mask = Masks[MaskIndex];
+        
+        started = 0;
+        if (clip1.X1 < clip1.X2) {
+            started |= __GUI_DRAW_CopyConvert(&clip1, x, y + line, width, lines, mask, GUI_PixelFormat_A8, 0, draw->Color1, 0xFF, 1);
+        }
+        if (clip2.X1 < clip2.X2) {
+            started |= __GUI_DRAW_CopyConvert(&clip2, x, y + line, width, lines, mask, GUI_PixelFormat_A8, 0, draw->Color2, 0xFF, 1);
+        }
+        if (started) {                              /* Switch buffer only when hardware may still read mask */
+            MaskIndex = !MaskIndex;
+        }
+    }
+}
+
+/* Check if bit for pixel is set in 1-bit mask line, MSB first */
+#define __MaskBit(mask, pos)        ((mask)[(pos) >> 3] & (0x80 >> ((pos) & 0x07)))
+
+/* Draw single line of 1-bit mask, x1 and x2 are already clipped visible pixels relative to screen */
+/* Pixels left of "split" coordinate use color c1, others use c2 */
+static
+void __DrawMaskLine(const GUI_Display_t* disp, const uint8_t* mask, GUI_iDim_t x, GUI_iDim_t y, GUI_iDim_t x1, GUI_iDim_t x2, GUI_iDim_t split, GUI_Color_t c1, GUI_Color_t c2) {
+    GUI_iDim_t xs, start;
+    
+    if (__IsDirect()) {                             /* Write mask directly to memory */
+        __WaitPendingArea(x1, y, x2 - 1, y);        /* Wait if line is inside area of pending operation */
+        xs = __GUI_MIN(__GUI_MAX(split, x1), x2);   /* Split position inside line */
+        if (x1 < xs) {
+            __Kernels()->MaskSpan(__PixelAddress(x1, y), mask, x1 - x, xs - x1, c1);
+        }
+        if (xs < x2) {
+            __Kernels()->MaskSpan(__PixelAddress(xs, y), mask, xs - x, x2 - xs, c2);
+        }
+        return;
+    }
+    while (x1 < x2) {                               /* Emit runs of set bits as lines */
+        if (!__MaskBit(mask, x1 - x)) {
+            x1++;
+            continue;
+        }
+        start = x1;
+        do {                                        /* Run ends on cleared bit or on color split */
+            x1++;
+        } while (x1 < x2 && x1 != split && __MaskBit(mask, x1 - x));
+        __HLine_LCD(disp, start, y, x1 - start, start < split ? c1 : c2);
+    }
+}
+
+/* Blend run of anti-aliased line pixel pairs from current mask buffer, run starts at "maj" on major axis and "min" on minor axis */
+static
+void __LineAAFlush(const GUI_Display_t* disp, uint8_t xMajor, GUI_iDim_t maj, GUI_iDim_t min, GUI_iDim_t inc, GUI_iDim_t* n, GUI_Color_t color) {
+    uint8_t started;
+    
+    if (!*n) {
+        return;
+    }
+    if (inc < 0) {                                  /* Second pixel of each pair is before first one */
+        min--;
+    }
+    if (xMajor) {                                   /* Two lines of pixels */
+        started = __GUI_DRAW_CopyConvert(disp, maj, min, *n, 2, Masks[MaskIndex], GUI_PixelFormat_A8, __MASK_SIZE / 2 - *n, color, 0xFF, 1);
+    } else {                                        /* Two columns of pixels */
+        started = __GUI_DRAW_CopyConvert(disp, min, maj, 2, *n, Masks[MaskIndex], GUI_PixelFormat_A8, 0, color, 0xFF, 1);
+    }
+    if (started) {                                  /* Hardware may still read mask, other buffer is free */
+        MaskIndex = !MaskIndex;
+    }
+    *n = 0;
+}
+
+/* Draw anti-aliased line with Wu algorithm, end point is not drawn when "last" is 0 so joined lines blend shared point once */
+/* Pixel pairs across line are collected to A8 mask while minor coordinate does not change and blended as single rectangle */
+static
+void __LineAA(const GUI_Display_t* disp, GUI_iDim_t x1, GUI_iDim_t y1, GUI_iDim_t x2, GUI_iDim_t y2, GUI_Color_t color, uint8_t last) {
+    GUI_iDim_t maj, min, minEnd, dmaj, dmin, inc, rmaj = 0, rmin = 0, n = 0;
+    int32_t i, first, end;
+    uint32_t adj, acc;
+    uint16_t stride, side, pos;
+    GUI_Byte w;
+    uint8_t xMajor;
+    
+    if (__IsClipEmpty(disp) || !__GUI_RECT_MATCH(
+        disp->X1, disp->Y1, disp->X2 - 1, disp->Y2 - 1,
+        __GUI_MIN(x1, x2) - 1, __GUI_MIN(y1, y2) - 1, __GUI_MAX(x1, x2) + 1, __GUI_MAX(y1, y2) + 1
+    )) {
+        return;
+    }
+    if (x1 == x2 && y1 == y2) {                     /* Single point */
+        if (last) {
+            GUI_DRAW_SetPixel(disp, x1, y1, color);
+        }
+        return;
+    }
+    
+    /* Walk line in increasing direction of major axis */
+    xMajor = __GUI_ABS(x2 - x1) >= __GUI_ABS(y2 - y1);
+    first = 0;
+    end = last ? 0 : -1;                            /* Offset of last drawn point from end point */
+    if (xMajor ? x2 < x1 : y2 < y1) {
+        GUI_iDim_t tmp;
+        tmp = x1, x1 = x2, x2 = tmp;
+        tmp = y1, y1 = y2, y2 = tmp;
+        first = -end;                               /* Skipped point is now first one */
+        end = 0;
+    }
+    maj = xMajor ? x1 : y1;
+    min = xMajor ? y1 : x1;
+    minEnd = xMajor ? y2 : x2;
+    dmaj = xMajor ? x2 - x1 : y2 - y1;
+    dmin = minEnd - min;
+    inc = dmin < 0 ? -1 : 1;
+    dmin = __GUI_ABS(dmin);
+    end += dmaj;
+    
+    /* Clip steps on major axis, minor axis is clipped by blend operation */
+    first = __GUI_MAX(first, (int32_t)(xMajor ? disp->X1 : disp->Y1) - maj);
+    end = __GUI_MIN(end, (int32_t)(xMajor ? disp->X2 : disp->Y2) - 1 - maj);
+    if (first > end) {
+        return;
+    }
+    
+    adj = ((uint32_t)dmin << 16) / dmaj;            /* Minor axis step per major step in 16.16 fixed point */
+    acc = (uint32_t)first * adj;                    /* Move to first visible step */
+    min += inc * (GUI_iDim_t)(acc >> 16);
+    acc &= 0xFFFF;
+    
+    stride = xMajor ? 1 : 2;                        /* Mask index step along line */
+    side = xMajor ? __MASK_SIZE / 2 : 1;            /* Mask index step across line */
+    pos = inc > 0 ? 0 : side;                       /* Mask index offset of pixel on line start side */
+    for (i = first; i <= end; i++) {
+        w = acc >> 8;                               /* Coverage of second pixel, first pixel gets the rest */
+        if (i == dmaj) {                            /* End point is drawn exactly */
+            if (min != minEnd) {
+                __LineAAFlush(disp, xMajor, rmaj, rmin, inc, &n, color);
+                min = minEnd;
+            }
+            w = 0;
+        }
+        if (n == __MASK_SIZE / 2) {                 /* Mask buffer is full */
+            __LineAAFlush(disp, xMajor, rmaj, rmin, inc, &n, color);
+        }
+        if (!n) {                                   /* Start new run */
+            rmaj = maj + i;
+            rmin = min;
+        }
+        Masks[MaskIndex][n * stride + pos] = 0xFF - w;
+        Masks[MaskIndex][n * stride + side - pos] = w;
+        n++;
+        
+        acc += adj;
+        if (acc >= 0x10000) {                       /* Minor coordinate changes, finish run */
+            acc -= 0x10000;
+            __LineAAFlush(disp, xMajor, rmaj, rmin, inc, &n, color);
+            min += inc;
+        }
+    }
+    __LineAAFlush(disp, xMajor, rmaj, rmin, inc, &n, color);
+}
+
 /* Draw character to screen */
 /* X and Y coordinates are TOP LEFT coordinates for character */
 void __DRAW_Char(const GUI_Display_t* disp, const GUI_FONT_t* font, GUI_DRAW_FONT_t* draw, GUI_iDim_t x, GUI_iDim_t y, const GUI_FONT_CharInfo_t* c) {
     GUI_Byte i, b;
-    GUI_iDim_t x1;
+    GUI_iDim_t x1, x2, y1, y2;
     GUI_iByte k;
     GUI_Byte columns;
+    GUI_Color_t c1, c2;
     
     y += c->yPos;                                   /* Set Y position */
+    c1 = __GUI_DRAW_ColorToLCD(draw->Color1);       /* Convert solid colors once per character */
+    c2 = __GUI_DRAW_ColorToLCD(draw->Color2);
     
     if (font->Flags & GUI_FLAG_FONT_AA) {           /* Font has anti alliasing enabled */
-        GUI_Color_t color;                          /* Temporary color for AA */
-        GUI_Byte tmp, r1, g1, b1;
+        GUI_Byte tmp;
         
         columns = c->xSize / 4;                     /* Calculate number of bytes used for single character line */
         if (c->xSize % 4) {                         /* If only 1 column used */
             columns++;
         }   
         
+        if ((GUI.LL.CopyConvert || GUI.LL.WritePixels) && columns * 4 <= __MASK_SIZE) { /* Blend complete character as mask */
+            __DrawCharMask(disp, font, draw, x, y, columns, c);
+            return;
+        }
         for (i = 0; i < columns * c->ySize; i++) {  /* Go through all data bytes */
             if (y >= disp->Y1 && y <= disp->Y2 && y < (draw->Y + draw->Height)) {   /* Do not draw when we are outside clipping are */            
                 b = c->Data[i];                     /* Get character byte */
@@ -177,18 +924,9 @@ void __DRAW_Char(const GUI_Display_t* disp, const GUI_FONT_t* font, GUI_DRAW_FON
                     }
                     tmp = (b >> (6 - 2 * k)) & 0x03;/* Get temporary bits on bottom */
                     if (tmp == 0x03) {              /* Draw solid color if both bits are enabled */
-                        GUI_DRAW_SetPixel(disp, x1, y, baseColor);
-                    } else if (tmp) {               /* Calculate new color */
-                        float t = (float)tmp / 3.0f;
-                        color = GUI_DRAW_GetPixel(disp, x1, y); /* Read current color */
-                        
-                        /* Calculate new values for pixel */
-                        r1 = (float)t * (float)((color >> 16) & 0xFF) + (float)(1.0f - (float)t) * (float)((baseColor >> 16) & 0xFF);
-                        g1 = (float)t * (float)((color >>  8) & 0xFF) + (float)(1.0f - (float)t) * (float)((baseColor >>  8) & 0xFF);
-                        b1 = (float)t * (float)((color >>  0) & 0xFF) + (float)(1.0f - (float)t) * (float)((baseColor >>  0) & 0xFF);
-                        
-                        /* Draw actual pixel to screen */
-                        GUI_DRAW_SetPixel(disp, x1, y, (color & 0xFF000000UL) | r1 << 16 | g1 << 8 | b1);
+                        __SetPixel_LCD(disp, x1, y, baseColor == draw->Color1 ? c1 : c2);
+                    } else if (tmp) {               /* Blend with current color */
+                        __SetPixel_LCD(disp, x1, y, __GUI_DRAW_ColorToLCD(__BlendAA(GUI_DRAW_GetPixel(disp, x1, y), baseColor, tmp)));
                     }
                 }
             }
@@ -201,26 +939,14 @@ void __DRAW_Char(const GUI_Display_t* disp, const GUI_FONT_t* font, GUI_DRAW_FON
         if (c->xSize % 8) {
             columns++;
         }
-        for (i = 0; i < columns * c->ySize; i++) {  /* Go through all data bytes */
-            if (y >= disp->Y1 && y <= disp->Y2 && y < (draw->Y + draw->Height)) {   /* Do not draw when we are outside clipping are */
-                b = c->Data[i];                     /* Get character byte */
-                for (k = 0; k < 8; k++) {           /* Scan each bit in byte */
-                    if (b & (1 << (7 - k))) {       /* If bit is set, draw pixel */
-                        x1 = x + (i % columns) * 8 + k; /* Get new X value for pixel draw */
-                        if (x1 < disp->X1 || x1 > disp->X2) {
-                            continue;
-                        }
-                        if (x1 <= (draw->X + draw->Color1Width)) {
-                            GUI_DRAW_SetPixel(disp, x1, y, draw->Color1);
-                        } else {
-                            GUI_DRAW_SetPixel(disp, x1, y, draw->Color2);
-                        }
-                    }
-                }
-            }
-            if ((i % columns) == (columns - 1)) {   /* Check for next line */
-                y++;
-            }
+        
+        /* Clip character once, lines and columns outside are not processed */
+        x1 = __GUI_MAX(x, disp->X1);
+        x2 = __GUI_MIN(x + columns * 8, disp->X2);
+        y1 = __GUI_MAX(y, disp->Y1);
+        y2 = __GUI_MIN(__GUI_MIN(y + c->ySize, disp->Y2), draw->Y + draw->Height);
+        for (; y1 < y2; y1++) {                     /* Draw visible lines as runs */
+            __DrawMaskLine(disp, &c->Data[(y1 - y) * columns], x, y1, x1, x2, draw->X + draw->Color1Width + 1, c1, c2);
         }
     }
 }
@@ -266,71 +992,211 @@ void GUI_DRAW_FONT_Init(GUI_DRAW_FONT_t* f) {
     memset((void *)f, 0x00, sizeof(*f));            /* Reset structure */
 }
 
-/******************************************************************************/
-/******************************************************************************/
-/***                    Functions with low-level communication               **/
-/******************************************************************************/
-/******************************************************************************/
-void GUI_DRAW_FillScreen(const GUI_Display_t* disp, GUI_Color_t color) {
-    GUI.LL.Fill(&GUI.LCD, GUI.LCD.DrawingLayer, 0, GUI.LCD.Width, GUI.LCD.Height, 0, color);
+void __GUI_DRAW_SetPending(GUI_Byte layer, GUI_iDim_t x, GUI_iDim_t y, GUI_iDim_t width, GUI_iDim_t height) {
+    if (!GUI.LL.IsBusy) {                           /* Low-level operations are blocking */
+        return;
+    }
+    PendingLayer = layer;                           /* Only one hardware operation may be active at a time */
+    PendingArea.X1 = x;
+    PendingArea.Y1 = y;
+    PendingArea.X2 = x + width - 1;                 /* Use inclusive coordinates */
+    PendingArea.Y2 = y + height - 1;
+    PendingValid = 1;
 }
 
-void GUI_DRAW_Fill(const GUI_Display_t* disp, GUI_iDim_t x, GUI_iDim_t y, GUI_iDim_t width, GUI_iDim_t height, GUI_Color_t color) {
-    if (                                            /* Check if redraw is inside area */
-        x >= disp->X2 ||                            /* Too right */
-        y >= disp->Y2 ||                            /* Too bottom */
-        (x + width) < disp->X1 ||                   /* Too left */
-        (y + height) < disp->Y1                     /* Too top */
-        ) {
-        return;
+void __GUI_DRAW_WaitPending(void) {
+    if (PendingValid) {                             /* Check if anything started */
+        while (GUI.LL.IsBusy(&GUI.LCD));            /* Wait hardware to finish operation */
+        PendingValid = 0;
     }
+}
+
+void __GUI_DRAW_SetPalette(void) {
+    const GUI_Color_t* pal = GUI.LCD.Palette;
+    uint16_t i, cell;
     
-    /* We are in region */
-    if (x < disp->X1) {
-        width -= (disp->X1 - x);
-        x = disp->X1;
+    if (!pal) {                                     /* Default palette is converted with shifts */
+        if (PaletteLookup) {
+            __GUI_MEMFREE(PaletteLookup);
+            PaletteLookup = 0;
+        }
+        return;
     }
-    if (y < disp->Y1) {
-        height -= (disp->Y1 - y);
-        y = disp->Y1;
+    if (!PaletteLookup) {
+        PaletteLookup = (GUI_Byte *)__GUI_MEMALLOC(4096 + 512);
+        if (!PaletteLookup) {
+            __GUI_DEBUG("Alloc failed for palette lookup table with %d bytes\r\n", 4096 + 512);
+            return;
+        }
+        PaletteShared = &PaletteLookup[4096];
     }
-    
-    /* Check out of regions */
-    if ((x + width) > disp->X2) {
-        width = disp->X2 - x;
+    for (i = 0; i < 4096; i++) {                    /* Nearest color for center of each RGB444 cell */
+        PaletteLookup[i] = __PaletteSearch(pal, GUI.LCD.PaletteSize, ((GUI_Color_t)(i >> 8) * 0x11) << 16 | (((i >> 4) & 0x0F) * 0x11) << 8 | (i & 0x0F) * 0x11);
     }
-    if ((y + height) > disp->Y2) {
-        height = disp->Y2 - y;
+    for (i = GUI.LCD.PaletteSize; i > 0; i--) {     /* Palette colors claim their cell, first one wins */
+        PaletteLookup[((pal[i - 1] >> 12) & 0xF00) | ((pal[i - 1] >> 8) & 0x0F0) | ((pal[i - 1] >> 4) & 0x00F)] = i - 1;
+    }
+    memset(PaletteShared, 0x00, 512);
+    for (i = 0; i < GUI.LCD.PaletteSize; i++) {     /* Mark cells where other palette color lost */
+        cell = ((pal[i] >> 12) & 0xF00) | ((pal[i] >> 8) & 0x0F0) | ((pal[i] >> 4) & 0x00F);
+        if ((pal[PaletteLookup[cell]] ^ pal[i]) & 0x00FFFFFFUL) {
+            PaletteShared[cell >> 3] |= 1 << (cell & 0x07);
+        }
     }
-    GUI.LL.FillRect(&GUI.LCD, GUI.LCD.DrawingLayer, x, y, width, height, color);
 }
 
-void GUI_DRAW_SetPixel(const GUI_Display_t* disp, GUI_iDim_t x, GUI_iDim_t y, GUI_Color_t color) {
-    if (y < disp->Y1 || y >= disp->Y2 || x < disp->X1 || x >= disp->X2) {
-        return;
+GUI_Color_t __GUI_DRAW_ColorToLCD(GUI_Color_t color) {
+    switch (GUI.LCD.PixelFormat) {
+        case GUI_PixelFormat_RGB565:
+            return __RGB565_FROM_ARGB(color);
+        case GUI_PixelFormat_L8:
+            return __PaletteIndex(color);
+        default:
+            return color;
     }
-    GUI.LL.SetPixel(&GUI.LCD, GUI.LCD.DrawingLayer, x, y, color);
 }
 
-GUI_Color_t GUI_DRAW_GetPixel(const GUI_Display_t* disp, GUI_iDim_t x, GUI_iDim_t y) {
-    return GUI.LL.GetPixel(&GUI.LCD, GUI.LCD.DrawingLayer, x, y);
+GUI_Color_t __GUI_DRAW_ColorFromLCD(GUI_Color_t color) {
+    switch (GUI.LCD.PixelFormat) {
+        case GUI_PixelFormat_L8:
+            color &= 0xFF;
+            if (GUI.LCD.Palette) {
+                return color < GUI.LCD.PaletteSize ? (GUI.LCD.Palette[color] | 0xFF000000UL) : GUI_COLOR_BLACK;
+            }
+            return __ARGB_FROM_RGB332(color);
+        case GUI_PixelFormat_RGB565:
+            return __ARGB_FROM_RGB565(color);
+        default:
+            return color;
+    }
 }
 
-void GUI_DRAW_VLine(const GUI_Display_t* disp, GUI_iDim_t x, GUI_iDim_t y, GUI_iDim_t length, GUI_Color_t color) {
-    if (x >= disp->X2 || x < disp->X1 || y > disp->Y2 || (y + length) < disp->Y1) {
-        return;
-    }
-    if (y < disp->Y1) {
-        length -= disp->Y1 - y;
-        y = disp->Y1;
+/******************************************************************************/
+/******************************************************************************/
+/***                    Functions with low-level communication               **/
+/******************************************************************************/
+/******************************************************************************/
+/**
+ * Static functions with _LCD suffix expect color already converted with __GUI_DRAW_ColorToLCD.
+ * Primitives with multiple low-level calls convert color once and use them directly.
+ */
+static
+void __Fill_LCD(const GUI_Display_t* disp, GUI_iDim_t x, GUI_iDim_t y, GUI_iDim_t width, GUI_iDim_t height, GUI_Color_t color) {
+    if (!__ClipRect(disp, &x, &y, &width, &height)) {
+        return;
+    }
+    GUI.LL.FillRect(&GUI.LCD, GUI.LCD.DrawingLayer, x, y, width, height, color);
+    __GUI_DRAW_SetPending(GUI.LCD.DrawingLayer, x, y, width, height);
+}
+
+/* Read pixel in ARGB8888 format, pending operations on pixel must be already finished */
+static
+GUI_Color_t __ReadPixel(GUI_iDim_t x, GUI_iDim_t y) {
+    if (__IsDirect()) {
+        return __GUI_DRAW_ColorFromLCD(__Kernels()->GetPixel(__PixelAddress(x, y)));
+    }
+    return __GUI_DRAW_ColorFromLCD(GUI.LL.GetPixel(&GUI.LCD, GUI.LCD.DrawingLayer, x, y));
+}
+
+/* Write rectangle of pixels in LCD format, area must be already clipped */
+/* Returns 1 when hardware operation was started and pixels may be read until it finishes */
+static
+uint8_t __WritePixels_LCD(GUI_iDim_t x, GUI_iDim_t y, GUI_iDim_t width, GUI_iDim_t height, const void* pixels, GUI_iDim_t offLine) {
+    const uint8_t* p = (const uint8_t *)pixels;
+    uint8_t size = __GUI_LCD_PIXEL_SIZE();
+    GUI_iDim_t i, k;
+    
+    if (GUI.LL.WritePixels) {                       /* Write all pixels with single call */
+        GUI.LL.WritePixels(&GUI.LCD, GUI.LCD.DrawingLayer, x, y, width, height, pixels, offLine);
+        __GUI_DRAW_SetPending(GUI.LCD.DrawingLayer, x, y, width, height);
+        return 1;
+    }
+    __WaitPendingArea(x, y, x + width - 1, y + height - 1);
+    for (i = 0; i < height; i++, p += size * offLine) {
+        if (__IsDirect()) {                         /* Copy complete line to memory */
+            __Kernels()->CopySpan(__PixelAddress(x, y + i), p, width);
+            p += size * width;
+            continue;
+        }
+        for (k = 0; k < width; k++, p += size) {
+            GUI.LL.SetPixel(&GUI.LCD, GUI.LCD.DrawingLayer, x + k, y + i, __Kernels()->GetPixel(p));
+        }
+    }
+    return 0;
+}
+
+/* Blend ARGB8888 color with its alpha over rectangle, used for colors which are not opaque */
+/* Software blending reads background to line buffer when frame buffer is not accessible directly */
+static
+void __FillBlend(const GUI_Display_t* disp, GUI_iDim_t x, GUI_iDim_t y, GUI_iDim_t width, GUI_iDim_t height, GUI_Color_t color) {
+    GUI_iDim_t i, k, j, len;
+    uint8_t* d;
+    
+    if (!(color >> 24) || !__ClipRect(disp, &x, &y, &width, &height)) {
+        return;                                     /* Transparent color or invisible area */
+    }
+    if (GUI.LL.BlendRect && !GUI.LL.BlendRect(&GUI.LCD, GUI.LCD.DrawingLayer, x, y, width, height, color)) {
+        __GUI_DRAW_SetPending(GUI.LCD.DrawingLayer, x, y, width, height);
+        return;
+    }
+    
+    __WaitPendingArea(x, y, x + width - 1, y + height - 1);
+    for (i = 0; i < height; i++) {
+        if (__IsDirect()) {                         /* Blend complete line in memory */
+            __Kernels()->BlendSpan(__PixelAddress(x, y + i), width, color, color >> 24);
+            continue;
+        }
+        for (k = 0; k < width; k += len) {
+            len = __GUI_MIN(width - k, __ROW_SIZE);
+            d = (uint8_t *)Rows[RowIndex];          /* Buffer of operation before last one, already processed */
+            RowIndex = !RowIndex;
+            for (j = 0; j < len; j++, d += __GUI_LCD_PIXEL_SIZE()) {
+                __Kernels()->SolidSpan(d, 1, GUI.LL.GetPixel(&GUI.LCD, GUI.LCD.DrawingLayer, x + k + j, y + i));
+            }
+            __Kernels()->BlendSpan(Rows[!RowIndex], len, color, color >> 24);
+            __WritePixels_LCD(x + k, y + i, len, 1, Rows[!RowIndex], 0);
+        }
+    }
+}
+
+static
+void __SetPixel_LCD(const GUI_Display_t* disp, GUI_iDim_t x, GUI_iDim_t y, GUI_Color_t color) {
+    if (y < disp->Y1 || y >= disp->Y2 || x < disp->X1 || x >= disp->X2) {
+        return;
+    }
+    __WaitPendingArea(x, y, x, y);                  /* Wait if pixel is inside area of pending operation */
+    if (__IsDirect()) {
+        __Kernels()->SolidSpan(__PixelAddress(x, y), 1, color);
+    } else {
+        GUI.LL.SetPixel(&GUI.LCD, GUI.LCD.DrawingLayer, x, y, color);
+    }
+}
+
+static
+void __VLine_LCD(const GUI_Display_t* disp, GUI_iDim_t x, GUI_iDim_t y, GUI_iDim_t length, GUI_Color_t color) {
+    if (x >= disp->X2 || x < disp->X1 || y > disp->Y2 || (y + length) < disp->Y1) {
+        return;
+    }
+    if (y < disp->Y1) {
+        length -= disp->Y1 - y;
+        y = disp->Y1;
     }
     if ((y + length) > disp->Y2) {
         length = disp->Y2 - y;
     }
+    if (__IsDirect()) {                             /* Write pixels directly, one per line */
+        __WaitPendingArea(x, y, x, y + length - 1);
+        for (; length > 0; length--, y++) {
+            __Kernels()->SolidSpan(__PixelAddress(x, y), 1, color);
+        }
+        return;
+    }
     GUI.LL.DrawVLine(&GUI.LCD, GUI.LCD.DrawingLayer, x, y, length, color);
+    __GUI_DRAW_SetPending(GUI.LCD.DrawingLayer, x, y, 1, length);
 }
 
-void GUI_DRAW_HLine(const GUI_Display_t* disp, GUI_iDim_t x, GUI_iDim_t y, GUI_iDim_t length, GUI_Color_t color) {
+static
+void __HLine_LCD(const GUI_Display_t* disp, GUI_iDim_t x, GUI_iDim_t y, GUI_iDim_t length, GUI_Color_t color) {
     if (y >= disp->Y2 || y < disp->Y1 || x > disp->X2 || (x + length) < disp->X1) {
         return;
     }
@@ -341,7 +1207,410 @@ void GUI_DRAW_HLine(const GUI_Display_t* disp, GUI_iDim_t x, GUI_iDim_t y, GUI_i
     if ((x + length) > disp->X2) {
         length = disp->X2 - x;
     }
+    if (__IsDirect()) {                             /* Write span directly to memory */
+        __WaitPendingArea(x, y, x + length - 1, y);
+        __Kernels()->SolidSpan(__PixelAddress(x, y), length, color);
+        return;
+    }
     GUI.LL.DrawHLine(&GUI.LCD, GUI.LCD.DrawingLayer, x, y, length, color);
+    __GUI_DRAW_SetPending(GUI.LCD.DrawingLayer, x, y, length, 1);
+}
+
+/* Set up span rectangle for color, returned color is used for all spans */
+/* Opaque color is converted to LCD format, other colors are kept in ARGB8888 format for blending */
+static
+GUI_Color_t __SpanColor(__SpanRect_t* rect, GUI_Color_t color) {
+    rect->Blend = (color >> 24) != 0xFF;
+    return rect->Blend ? color : __GUI_DRAW_ColorToLCD(color);
+}
+
+/* Add span of lines to rectangle, rectangle is filled when span cannot be merged with it */
+/* Call with zero height to fill collected rectangle, color must be prepared with __SpanColor */
+static
+void __AddSpan_LCD(const GUI_Display_t* disp, __SpanRect_t* rect, GUI_iDim_t x, GUI_iDim_t y, GUI_iDim_t width, GUI_iDim_t height, GUI_Color_t color) {
+    if (rect->Height && rect->X == x && rect->Width == width && rect->Y + rect->Height == y) {
+        rect->Height += height;                     /* Same span on next lines */
+        return;
+    }
+    if (rect->Height && rect->Width > 0) {
+        if (rect->Blend) {
+            __FillBlend(disp, rect->X, rect->Y, rect->Width, rect->Height, color);
+        } else {
+            __Fill_LCD(disp, rect->X, rect->Y, rect->Width, rect->Height, color);
+        }
+    }
+    rect->X = x;
+    rect->Y = y;
+    rect->Width = width;
+    rect->Height = height;
+}
+
+/* Get width of filled circle corner for lines 1 to r from corner origin with midpoint algorithm */
+/* Returned buffer must be released with __CircleExtentsFree */
+static
+GUI_iDim_t* __CircleExtents(GUI_iDim_t r) {
+    GUI_iDim_t f = 1 - r;
+    GUI_iDim_t ddF_x = 1;
+    GUI_iDim_t ddF_y = -2 * r;
+    GUI_iDim_t x = 0;
+    GUI_iDim_t y = r;
+    GUI_iDim_t* ext = CircleExtents;
+    
+    if (r > __CIRCLE_EXTENTS) {                     /* Too many lines for static buffer */
+        ext = (GUI_iDim_t *)__GUI_MEMALLOC((r + 1) * sizeof(*ext));
+        if (!ext) {
+            return 0;
+        }
+    }
+    memset(ext, 0x00, (r + 1) * sizeof(*ext));
+    while (x < y) {                                 /* Each line gets widest point of both octants */
+        if (f >= 0) {
+            y--;
+            ddF_y += 2;
+            f += ddF_y;
+        }
+        x++;
+        ddF_x += 2;
+        f += ddF_x;
+        
+        ext[y] = __GUI_MAX(ext[y], x);
+        ext[x] = __GUI_MAX(ext[x], y);
+    }
+    ext[r] = __GUI_MAX(ext[r], 1);                  /* Outer line always covers corner center pixel */
+    return ext;
+}
+
+static
+void __CircleExtentsFree(GUI_iDim_t* ext) {
+    if (ext != CircleExtents) {
+        __GUI_MEMFREE(ext);
+    }
+}
+
+/* Fill rectangle with rounded corners with single span per line, equal spans on consecutive lines are filled together */
+static
+void __FillRoundRect(const GUI_Display_t* disp, GUI_iDim_t x, GUI_iDim_t y, GUI_iDim_t width, GUI_iDim_t height, GUI_iDim_t r, GUI_Color_t color) {
+    __SpanRect_t rect = {0};
+    GUI_iDim_t* ext;
+    GUI_iDim_t k;
+    
+    if (__IsClipEmpty(disp) || !__GUI_RECT_MATCH(
+        disp->X1, disp->Y1, disp->X2 - 1, disp->Y2 - 1,
+        x, y, x + width - 1, y + height - 1
+    ) || !(ext = __CircleExtents(r))) {
+        return;
+    }
+    color = __SpanColor(&rect, color);              /* Convert color once for all spans */
+    for (k = r; k > 0; k--) {                       /* Top corners */
+        __AddSpan_LCD(disp, &rect, x + r - ext[k], y + r - k, width - 2 * (r - ext[k]), 1, color);
+    }
+    if (height > 2 * r) {                           /* Lines between corners */
+        __AddSpan_LCD(disp, &rect, x, y + r, width, height - 2 * r, color);
+    }
+    for (k = 1; k <= r; k++) {                      /* Bottom corners */
+        __AddSpan_LCD(disp, &rect, x + r - ext[k], y + height - r - 1 + k, width - 2 * (r - ext[k]), 1, color);
+    }
+    __AddSpan_LCD(disp, &rect, 0, 0, 0, 0, color);  /* Fill last rectangle */
+    __CircleExtentsFree(ext);
+}
+
+/* Get coverage of pixel for circle with radius r, dx and dy are doubled offsets of pixel center from circle center */
+static
+GUI_Byte __CircleCoverage(int32_t dx, int32_t dy, GUI_iDim_t r) {
+    int32_t d2 = dx * dx + dy * dy, a;
+    
+    if (d2 <= (2 * r - 1) * (2 * r - 1)) {          /* Pixel is completely inside */
+        return 0xFF;
+    }
+    if (d2 >= (2 * r + 1) * (2 * r + 1)) {          /* Pixel is completely outside */
+        return 0x00;
+    }
+    a = 128 - (255 * (d2 - 4 * r * r)) / (8 * r);   /* Distance from edge is (d2 - 4 * r * r) / (8 * r) pixels */
+    return __GUI_MIN(__GUI_MAX(a, 0), 0xFF);
+}
+
+/* Fill rectangle or rounded rectangle with gradient, colors are computed per span with fixed-point stepping */
+/* Vertical gradient without dither is filled with single span per line, other types are written pixel by pixel */
+static
+void __FillGradient(const GUI_Display_t* disp, GUI_iDim_t x, GUI_iDim_t y, GUI_iDim_t width, GUI_iDim_t height, GUI_iDim_t r, const GUI_Gradient_t* gradient, GUI_DRAW_Gradient_t type, uint8_t dither) {
+    GUI_iDim_t* ext = 0;
+    GUI_iDim_t line, y1, y2, x1, x2, xs, len, j, k;
+    GUI_Color_t start = gradient->Start, stop = gradient->Stop;
+    uint32_t dist, d2, dy2;
+    int32_t c[3], cx2, dx2;
+    __Gradient_t g;
+    uint8_t* d;
+    uint8_t i, direct = __IsDirect() ? 1 : 0;
+    
+    y1 = __GUI_MAX(y, disp->Y1);                    /* Visible lines */
+    y2 = __GUI_MIN(y + height, disp->Y2);
+    if (width <= 0 || y1 >= y2 || __IsClipEmpty(disp) || x >= disp->X2 || x + width <= disp->X1) {
+        return;
+    }
+    if (r > 0 && !(ext = __CircleExtents(r))) {
+        return;
+    }
+    
+    if (type == GUI_DRAW_Gradient_BottomTop || type == GUI_DRAW_Gradient_RightLeft) {
+        start = gradient->Stop;                     /* Reverse direction is the same gradient with swapped colors */
+        stop = gradient->Start;
+        type = type == GUI_DRAW_Gradient_BottomTop ? GUI_DRAW_Gradient_TopBottom : GUI_DRAW_Gradient_LeftRight;
+    }
+    dither = dither && GUI.LCD.PixelFormat == GUI_PixelFormat_RGB565;
+    cx2 = 2 * x + width - 1;                        /* Center of rectangle in doubled coordinates */
+    switch (type) {
+        case GUI_DRAW_Gradient_TopBottom:
+            __GradientInit(&g, start, stop, height - 1);
+            break;
+        case GUI_DRAW_Gradient_LeftRight:
+            __GradientInit(&g, start, stop, width - 1);
+            break;
+        default:                                    /* Radial, distance to corner pixel in doubled coordinates */
+            __GradientInit(&g, start, stop, __Sqrt((uint32_t)(width - 1) * (width - 1) + (uint32_t)(height - 1) * (height - 1)));
+            break;
+    }
+    if (direct && (type != GUI_DRAW_Gradient_TopBottom || dither)) {
+        __WaitPendingArea(x, y1, x + width - 1, y2 - 1);
+    }
+    
+    for (line = y1; line < y2; line++) {
+        x1 = x;                                     /* Span of rounded rectangle on this line */
+        x2 = x + width;
+        k = line < y + r ? y + r - line : (line >= y + height - r ? line - (y + height - r - 1) : 0);
+        if (k) {
+            x1 += r - ext[k];
+            x2 -= r - ext[k];
+        }
+        x1 = __GUI_MAX(x1, disp->X1);
+        x2 = __GUI_MIN(x2, disp->X2);
+        if (x1 >= x2) {
+            continue;
+        }
+        
+        if (type == GUI_DRAW_Gradient_TopBottom && !dither) {   /* Single color for complete line */
+            for (i = 0; i < 3; i++) {
+                c[i] = g.Color[i] + g.Step[i] * (line - y);
+            }
+            __Fill_LCD(disp, x1, line, x2 - x1, 1, __GUI_DRAW_ColorToLCD(__GradientColor(c, 0, 0, 0)));
+            continue;
+        }
+        
+        dy2 = (uint32_t)(2 * line - (2 * y + height - 1)) * (2 * line - (2 * y + height - 1));
+        for (xs = x1; xs < x2; xs += len) {
+            len = __GUI_MIN(x2 - xs, __ROW_SIZE);
+            if (direct) {
+                d = (uint8_t *)__PixelAddress(xs, line);
+            } else {
+                d = (uint8_t *)Rows[RowIndex];      /* Buffer of operation before last one, already processed */
+                RowIndex = !RowIndex;
+            }
+            for (i = 0; i < 3; i++) {               /* Color of first pixel for linear gradients */
+                c[i] = g.Color[i] + g.Step[i] * (type == GUI_DRAW_Gradient_TopBottom ? line - y : xs - x);
+            }
+            dx2 = 2 * xs - cx2;
+            d2 = (uint32_t)dx2 * dx2 + dy2;
+            dist = __Sqrt(d2);
+            for (j = 0; j < len; j++, d += __GUI_LCD_PIXEL_SIZE()) {
+                if (type == GUI_DRAW_Gradient_Radial) {
+                    for (i = 0; i < 3; i++) {
+                        c[i] = g.Color[i] + g.Step[i] * (int32_t)dist;
+                    }
+                    dx2 += 2;                       /* Distance changes by at most 2 for next pixel */
+                    d2 = (uint32_t)dx2 * dx2 + dy2;
+                    while (dist && dist * dist > d2) {
+                        dist--;
+                    }
+                    while ((dist + 1) * (dist + 1) <= d2) {
+                        dist++;
+                    }
+                }
+                __Kernels()->SolidSpan(d, 1, __GUI_DRAW_ColorToLCD(__GradientColor(c, xs + j, line, dither)));
+                if (type == GUI_DRAW_Gradient_LeftRight) {
+                    for (i = 0; i < 3; i++) {
+                        c[i] += g.Step[i];
+                    }
+                }
+            }
+            if (!direct) {
+                __WritePixels_LCD(xs, line, len, 1, Rows[!RowIndex], 0);
+            }
+        }
+    }
+    if (ext) {
+        __CircleExtentsFree(ext);
+    }
+}
+
+uint8_t GUI_DRAW_PushClip(GUI_Display_t* disp, GUI_iDim_t x, GUI_iDim_t y, GUI_iDim_t width, GUI_iDim_t height) {
+    if (ClipDepth < GUI_CLIP_STACK_SIZE) {
+        ClipStack[ClipDepth] = *disp;
+    } else {                                        /* Region cannot be restored, nothing is drawn until stack unwinds */
+        __GUI_DEBUG("Clip stack overflow in file %s on line %d\r\n", __FILE__, __LINE__);
+        width = height = 0;
+    }
+    ClipDepth++;
+    
+    disp->X1 = __GUI_MAX(disp->X1, x);              /* Intersect current region with rectangle */
+    disp->Y1 = __GUI_MAX(disp->Y1, y);
+    disp->X2 = __GUI_MIN(disp->X2, x + width);
+    disp->Y2 = __GUI_MIN(disp->Y2, y + height);
+    if (__IsClipEmpty(disp)) {                      /* Keep empty region valid */
+        disp->X2 = disp->X1;
+        disp->Y2 = disp->Y1;
+        return 0;
+    }
+    return 1;
+}
+
+void GUI_DRAW_PopClip(GUI_Display_t* disp) {
+    if (!ClipDepth) {
+        return;
+    }
+    if (--ClipDepth < GUI_CLIP_STACK_SIZE) {
+        *disp = ClipStack[ClipDepth];
+    }
+}
+
+void GUI_DRAW_FillScreen(const GUI_Display_t* disp, GUI_Color_t color) {
+    GUI.LL.Fill(&GUI.LCD, GUI.LCD.DrawingLayer, (void *)GUI.LCD.Layers[GUI.LCD.DrawingLayer].StartAddress, GUI.LCD.Width, GUI.LCD.Height, 0, __GUI_DRAW_ColorToLCD(color));
+    __GUI_DRAW_SetPending(GUI.LCD.DrawingLayer, 0, 0, GUI.LCD.Width, GUI.LCD.Height);
+}
+
+void GUI_DRAW_Fill(const GUI_Display_t* disp, GUI_iDim_t x, GUI_iDim_t y, GUI_iDim_t width, GUI_iDim_t height, GUI_Color_t color) {
+    if ((color >> 24) != 0xFF) {                    /* Color is not opaque */
+        __FillBlend(disp, x, y, width, height, color);
+        return;
+    }
+    __Fill_LCD(disp, x, y, width, height, __GUI_DRAW_ColorToLCD(color));
+}
+
+void GUI_DRAW_SetPixel(const GUI_Display_t* disp, GUI_iDim_t x, GUI_iDim_t y, GUI_Color_t color) {
+    __SetPixel_LCD(disp, x, y, __GUI_DRAW_ColorToLCD(color));
+}
+
+GUI_Color_t GUI_DRAW_GetPixel(const GUI_Display_t* disp, GUI_iDim_t x, GUI_iDim_t y) {
+    __WaitPendingArea(x, y, x, y);                  /* Wait if pixel is inside area of pending operation */
+    return __ReadPixel(x, y);
+}
+
+void GUI_DRAW_VLine(const GUI_Display_t* disp, GUI_iDim_t x, GUI_iDim_t y, GUI_iDim_t length, GUI_Color_t color) {
+    if ((color >> 24) != 0xFF) {                    /* Color is not opaque */
+        __FillBlend(disp, x, y, 1, length, color);
+        return;
+    }
+    __VLine_LCD(disp, x, y, length, __GUI_DRAW_ColorToLCD(color));
+}
+
+void GUI_DRAW_HLine(const GUI_Display_t* disp, GUI_iDim_t x, GUI_iDim_t y, GUI_iDim_t length, GUI_Color_t color) {
+    if ((color >> 24) != 0xFF) {                    /* Color is not opaque */
+        __FillBlend(disp, x, y, length, 1, color);
+        return;
+    }
+    __HLine_LCD(disp, x, y, length, __GUI_DRAW_ColorToLCD(color));
+}
+
+uint8_t __GUI_DRAW_CopyConvert(const GUI_Display_t* disp, GUI_iDim_t x, GUI_iDim_t y, GUI_iDim_t width, GUI_iDim_t height, const void* src, GUI_PixelFormat_t format, GUI_Dim_t offLine, GUI_Color_t color, GUI_Byte alpha, uint8_t blend) {
+    const uint8_t* s = (const uint8_t *)src;
+    uint8_t* d;
+    uint8_t size = __FormatPixelSize(format), direct = __IsDirect() ? 1 : 0;
+    GUI_iDim_t i, k, j, len;
+    GUI_Color_t c, a;
+    
+    /* Clip area and move source pointer to first visible pixel */
+    if (x < disp->X1) {
+        s += size * (disp->X1 - x);
+        offLine += disp->X1 - x;
+        width -= disp->X1 - x;
+        x = disp->X1;
+    }
+    if (y < disp->Y1) {
+        s += size * (uint32_t)(disp->Y1 - y) * (width + offLine);
+        height -= disp->Y1 - y;
+        y = disp->Y1;
+    }
+    if ((x + width) > disp->X2) {
+        offLine += (x + width) - disp->X2;
+        width = disp->X2 - x;
+    }
+    if ((y + height) > disp->Y2) {
+        height = disp->Y2 - y;
+    }
+    if (width <= 0 || height <= 0 || !alpha) {
+        return 0;
+    }
+    
+    if (!blend && alpha == 0xFF && format == GUI.LCD.PixelFormat) { /* Source is in LCD format, copy it as is */
+        return __WritePixels_LCD(x, y, width, height, s, offLine);
+    }
+    if (GUI.LL.CopyConvert && !GUI.LL.CopyConvert(&GUI.LCD, GUI.LCD.DrawingLayer, s, __PixelAddress(x, y), format, width, height, offLine, GUI.LCD.Width - width, color, alpha, blend)) {
+        __GUI_DRAW_SetPending(GUI.LCD.DrawingLayer, x, y, width, height);
+        return 1;
+    }
+    
+    /* Software conversion, pixels are converted directly in memory or to line buffer written with single low-level call */
+    __WaitPendingArea(x, y, x + width - 1, y + height - 1);
+    for (i = 0; i < height; i++, s += size * offLine) {
+        for (k = 0; k < width; k += len) {
+            len = __GUI_MIN(width - k, __ROW_SIZE);
+            if (direct) {
+                d = (uint8_t *)__PixelAddress(x + k, y + i);
+            } else {
+                d = (uint8_t *)Rows[RowIndex];      /* Buffer of operation before last one, already processed */
+                RowIndex = !RowIndex;
+            }
+            for (j = 0; j < len; j++, s += size, d += __GUI_LCD_PIXEL_SIZE()) {
+                c = __ReadSourcePixel(s, format, color);
+                a = ((c >> 24) * alpha) / 255;      /* Combine pixel and global alpha */
+                if (!direct && blend && a != 0xFF) {/* Get destination pixel to blend over */
+                    __Kernels()->SolidSpan(d, 1, GUI.LL.GetPixel(&GUI.LCD, GUI.LCD.DrawingLayer, x + k + j, y + i));
+                }
+                if (!blend) {                       /* Convert only, keep alpha in pixel */
+                    __Kernels()->SolidSpan(d, 1, __GUI_DRAW_ColorToLCD((c & 0x00FFFFFFUL) | a << 24));
+                } else if (a == 0xFF) {             /* Opaque pixel */
+                    __Kernels()->SolidSpan(d, 1, __GUI_DRAW_ColorToLCD(c));
+                } else if (a) {                     /* Blend over destination */
+                    __Kernels()->BlendSpan(d, 1, c, a);
+                }
+            }
+            if (!direct) {
+                __WritePixels_LCD(x + k, y + i, len, 1, Rows[!RowIndex], 0);
+            }
+        }
+    }
+    return 0;
+}
+
+uint8_t __GUI_DRAW_BlendLayer(GUI_Byte layer, GUI_iDim_t x, GUI_iDim_t y, GUI_iDim_t width, GUI_iDim_t height, const void* src, GUI_Color_t color, GUI_Byte alpha) {
+    const uint8_t* s = (const uint8_t *)src;
+    uint8_t* d;
+    GUI_iDim_t i, k;
+    
+    if (src) {                                      /* Blend pixels of layer in LCD format */
+        if (GUI.LL.CopyConvert && !GUI.LL.CopyConvert(&GUI.LCD, layer, src, __LayerPixelAddress(layer, x, y), GUI.LCD.PixelFormat, width, height, GUI.LCD.Width - width, GUI.LCD.Width - width, 0, alpha, 1)) {
+            __GUI_DRAW_SetPending(layer, x, y, width, height);
+            return 0;
+        }
+    } else if (GUI.LL.BlendRect && !GUI.LL.BlendRect(&GUI.LCD, layer, x, y, width, height, (color & 0x00FFFFFFUL) | (GUI_Color_t)alpha << 24)) {
+        __GUI_DRAW_SetPending(layer, x, y, width, height);
+        return 0;
+    }
+    if (!__IsDirect()) {                            /* Layer memory does not match GUI coordinates */
+        return 1;
+    }
+    
+    __GUI_DRAW_WaitPending();                       /* Source and destination may be used by hardware */
+    for (i = 0; i < height; i++) {
+        d = (uint8_t *)__LayerPixelAddress(layer, x, y + i);
+        if (!src) {                                 /* Blend complete line with single color */
+            __Kernels()->BlendSpan(d, width, color, alpha);
+            continue;
+        }
+        for (k = 0; k < width; k++, s += __GUI_LCD_PIXEL_SIZE(), d += __GUI_LCD_PIXEL_SIZE()) {
+            __Kernels()->BlendSpan(d, 1, __GUI_DRAW_ColorFromLCD(__Kernels()->GetPixel(s)), alpha);
+        }
+        s += __GUI_LCD_PIXEL_SIZE() * (GUI.LCD.Width - width);
+    }
+    return 0;
 }
 
 /******************************************************************************/
@@ -349,13 +1618,31 @@ void GUI_DRAW_HLine(const GUI_Display_t* disp, GUI_iDim_t x, GUI_iDim_t y, GUI_i
 /***                          Functions for primitives                       **/
 /******************************************************************************/
 /******************************************************************************/
+/* Draw horizontal or vertical run of line, color is in LCD format unless it is blended */
+static
+void __LineRun(const GUI_Display_t* disp, GUI_iDim_t x, GUI_iDim_t y, GUI_iDim_t width, GUI_iDim_t height, GUI_Color_t color, uint8_t blend) {
+    if (blend) {
+        __FillBlend(disp, x, y, width, height, color);
+    } else if (width == 1 && height == 1) {
+        __SetPixel_LCD(disp, x, y, color);
+    } else if (height == 1) {
+        __HLine_LCD(disp, x, y, width, color);
+    } else {
+        __VLine_LCD(disp, x, y, height, color);
+    }
+}
+
 void GUI_DRAW_Line(const GUI_Display_t* disp, GUI_iDim_t x1, GUI_iDim_t y1, GUI_iDim_t x2, GUI_iDim_t y2, GUI_Color_t color) {
     GUI_iDim_t deltax = 0, deltay = 0, x = 0, y = 0, xinc1 = 0, xinc2 = 0, 
-    yinc1 = 0, yinc2 = 0, den = 0, num = 0, numadd = 0, numpixels = 0, 
-    curpixel = 0;
+    yinc1 = 0, yinc2 = 0, numpixels = 0, curpixel = 0, run = 0;
+    int32_t den = 0, num = 0, numadd = 0;           /* Sum of numerator and step may not fit to coordinate type */
+    int32_t first, last, lo, hi, mlo, mhi;
+    uint32_t step;
+    uint8_t blend = (color >> 24) != 0xFF;
     
     /* Check if coordinates are inside drawing region */
     if (
+        __IsClipEmpty(disp) ||                      /* Nothing is visible */
         (x1 < disp->X1 && x2 < disp->X1) ||         /* X coordinates outside left of display */
         (x1 > disp->X2 && x2 > disp->X2) ||         /* X coordinates outside right of display */
         (y1 < disp->Y1 && y2 < disp->Y1) ||         /* Y coordinates outside top of display */
@@ -366,13 +1653,24 @@ void GUI_DRAW_Line(const GUI_Display_t* disp, GUI_iDim_t x1, GUI_iDim_t y1, GUI_
 
 	deltax = __GUI_ABS(x2 - x1);
 	deltay = __GUI_ABS(y2 - y1);
+    if (!blend) {
+        color = __GUI_DRAW_ColorToLCD(color);       /* Convert color once for all pixels */
+    }
     
     if (deltax == 0) {                              /* Straight vertical line */
-        GUI_DRAW_VLine(disp, x1, __GUI_MIN(y1, y2), deltay, color);
+        if (blend) {
+            __FillBlend(disp, x1, __GUI_MIN(y1, y2), 1, deltay, color);
+        } else {
+            __VLine_LCD(disp, x1, __GUI_MIN(y1, y2), deltay, color);
+        }
         return;
     }
     if (deltay == 0) {                              /* Straight horizontal line */
-        GUI_DRAW_HLine(disp, __GUI_MIN(x1, x2), y1, deltax, color);
+        if (blend) {
+            __FillBlend(disp, __GUI_MIN(x1, x2), y1, deltax, 1, color);
+        } else {
+            __HLine_LCD(disp, __GUI_MIN(x1, x2), y1, deltax, color);
+        }
         return;
     }
 
@@ -410,10 +1708,47 @@ void GUI_DRAW_Line(const GUI_Display_t* disp, GUI_iDim_t x1, GUI_iDim_t y1, GUI_
         numadd = deltax;
         numpixels = deltay;
     }
+    
+    /* Clip line to visible steps, minor axis offset after N steps is (num + N * numadd) / den */
+    if (xinc2) {                                    /* X is major axis */
+        __LineAxisRange(x1, xinc2, disp->X1, disp->X2, &lo, &hi);
+        __LineAxisRange(y1, yinc1, disp->Y1, disp->Y2, &mlo, &mhi);
+    } else {                                        /* Y is major axis */
+        __LineAxisRange(y1, yinc2, disp->Y1, disp->Y2, &lo, &hi);
+        __LineAxisRange(x1, xinc1, disp->X1, disp->X2, &mlo, &mhi);
+    }
+    if (mlo > numadd || mhi < 0) {                  /* Minor axis never inside region */
+        return;
+    }
+    first = __GUI_MAX(lo, 0);
+    last = __GUI_MIN(hi, (int32_t)numpixels);
+    if (mlo > 0) {                                  /* First step with minor offset at least mlo */
+        first = __GUI_MAX(first, (int32_t)(((uint32_t)mlo * den - num + numadd - 1) / numadd));
+    }
+    if (mhi < numadd) {                             /* Last step with minor offset at most mhi */
+        last = __GUI_MIN(last, (int32_t)(((uint32_t)(mhi + 1) * den - num - 1) / numadd));
+    }
+    if (first > last) {
+        return;
+    }
+    
+    /* Move Bresenham state to first visible pixel to keep exact pixel sequence */
+    step = (uint32_t)num + (uint32_t)first * numadd;
+    num = step % den;
+    x += xinc2 * first + xinc1 * (step / den);
+    y += yinc2 * first + yinc1 * (step / den);
 
-    for (curpixel = 0; curpixel <= numpixels; curpixel++) {
-        GUI_DRAW_SetPixel(disp, x, y, color);
+    for (curpixel = first; curpixel <= last; curpixel++) {
+        run++;                                      /* Pixels on major axis are collected to single run */
         num += numadd;
+        if (num >= den || curpixel == last) {       /* Minor axis changes on next pixel, draw collected run */
+            if (xinc2) {
+                __LineRun(disp, xinc2 > 0 ? x - run + 1 : x, y, run, 1, color, blend);
+            } else {
+                __LineRun(disp, x, yinc2 > 0 ? y - run + 1 : y, 1, run, color, blend);
+            }
+            run = 0;
+        }
         if (num >= den) {
             num -= den;
             x += xinc1;
@@ -425,14 +1760,28 @@ void GUI_DRAW_Line(const GUI_Display_t* disp, GUI_iDim_t x1, GUI_iDim_t y1, GUI_
 }
 
 void GUI_DRAW_Rectangle(const GUI_Display_t* disp, GUI_iDim_t x, GUI_iDim_t y, GUI_iDim_t width, GUI_iDim_t height, GUI_Color_t color) {
-    if (width == 0 || height == 0) {
+    if (width == 0 || height == 0 || __IsClipEmpty(disp)) {
+        return;
+    }
+    if ((color >> 24) != 0xFF) {                    /* Sides do not overlap in corners, each pixel is blended once */
+        __FillBlend(disp, x, y, width, 1, color);
+        if (height > 1) {
+            __FillBlend(disp, x, y + height - 1, width, 1, color);
+        }
+        if (height > 2) {
+            __FillBlend(disp, x, y + 1, 1, height - 2, color);
+            if (width > 1) {
+                __FillBlend(disp, x + width - 1, y + 1, 1, height - 2, color);
+            }
+        }
         return;
     }
-    GUI_DRAW_HLine(disp, x,             y,              width,  color);
-    GUI_DRAW_VLine(disp, x,             y,              height, color);
+    color = __GUI_DRAW_ColorToLCD(color);           /* Convert color once for all lines */
+    __HLine_LCD(disp, x,             y,              width,  color);
+    __VLine_LCD(disp, x,             y,              height, color);
     
-    GUI_DRAW_HLine(disp, x,             y + height - 1, width,  color);
-    GUI_DRAW_VLine(disp, x + width - 1, y,              height, color);
+    __HLine_LCD(disp, x,             y + height - 1, width,  color);
+    __VLine_LCD(disp, x + width - 1, y,              height, color);
 }
 
 void GUI_DRAW_FilledRectangle(const GUI_Display_t* disp, GUI_iDim_t x, GUI_iDim_t y, GUI_iDim_t width, GUI_iDim_t height, GUI_Color_t color) {
@@ -453,11 +1802,13 @@ void GUI_DRAW_Rectangle3D(const GUI_Display_t* disp, GUI_iDim_t x, GUI_iDim_t y,
     
     GUI_DRAW_Rectangle(disp, x, y, width, height, c1);
     
-    GUI_DRAW_HLine(disp, x + 1, y + 1, width - 2, c2);
-    GUI_DRAW_VLine(disp, x + 1, y + 1, height - 2, c2);
+    c2 = __GUI_DRAW_ColorToLCD(c2);                 /* Convert colors once for all lines */
+    c3 = __GUI_DRAW_ColorToLCD(c3);
+    __HLine_LCD(disp, x + 1, y + 1, width - 2, c2);
+    __VLine_LCD(disp, x + 1, y + 1, height - 2, c2);
     
-    GUI_DRAW_HLine(disp, x + 1, y + height - 2, width - 2,  c3);
-    GUI_DRAW_VLine(disp, x + width - 2, y + 1, height - 2, c3);
+    __HLine_LCD(disp, x + 1, y + height - 2, width - 2,  c3);
+    __VLine_LCD(disp, x + width - 2, y + 1, height - 2, c3);
 }
 
 void GUI_DRAW_RoundedRectangle(const GUI_Display_t* disp, GUI_iDim_t x, GUI_iDim_t y, GUI_iDim_t width, GUI_iDim_t height, GUI_iDim_t r, GUI_Color_t color) {
@@ -489,94 +1840,353 @@ void GUI_DRAW_FilledRoundedRectangle(const GUI_Display_t* disp, GUI_iDim_t x, GU
     if (r >= (width / 2)) {
         r = width / 2 - 1;
     }
-    if (r) {
-        GUI_DRAW_FilledRectangle(disp, x + r,         y,     width - 2 * r, height,         color);
-        GUI_DRAW_FilledRectangle(disp, x,             y + r, r,             height - 2 * r, color);
-        GUI_DRAW_FilledRectangle(disp, x + width - r, y + r, r,             height - 2 * r, color);
-        
-        GUI_DRAW_FilledCircleCorner(disp, x + r,             y + r,              r, GUI_DRAW_CIRCLE_TL, color);
-        GUI_DRAW_FilledCircleCorner(disp, x + width - r - 1, y + r,              r, GUI_DRAW_CIRCLE_TR, color);
-        GUI_DRAW_FilledCircleCorner(disp, x + r,             y + height - r - 1, r, GUI_DRAW_CIRCLE_BL, color);
-        GUI_DRAW_FilledCircleCorner(disp, x + width - r - 1, y + height - r - 1, r, GUI_DRAW_CIRCLE_BR, color);
+    if (r > 0) {
+        __FillRoundRect(disp, x, y, width, height, r, color);
     } else {
         GUI_DRAW_FilledRectangle(disp, x, y, width, height, color);
     }
 }
 
-void GUI_DRAW_Circle(const GUI_Display_t* disp, GUI_iDim_t x, GUI_iDim_t y, GUI_iDim_t r, GUI_Color_t color) {
-    GUI_DRAW_CircleCorner(disp, x, y, r, GUI_DRAW_CIRCLE_TL, color);
-    GUI_DRAW_CircleCorner(disp, x - 1, y, r, GUI_DRAW_CIRCLE_TR, color);
-    GUI_DRAW_CircleCorner(disp, x, y - 1, r, GUI_DRAW_CIRCLE_BL, color);
-    GUI_DRAW_CircleCorner(disp, x - 1, y - 1, r, GUI_DRAW_CIRCLE_BR, color);
-}
-
-void GUI_DRAW_FilledCircle(const GUI_Display_t* disp, GUI_iDim_t x, GUI_iDim_t y, GUI_iDim_t r, GUI_Color_t color) {
-    GUI_DRAW_FilledCircleCorner(disp, x, y, r, GUI_DRAW_CIRCLE_TL, color);
-    GUI_DRAW_FilledCircleCorner(disp, x, y, r, GUI_DRAW_CIRCLE_TR, color);
-    GUI_DRAW_FilledCircleCorner(disp, x, y - 1, r, GUI_DRAW_CIRCLE_BL, color);
-    GUI_DRAW_FilledCircleCorner(disp, x, y - 1, r, GUI_DRAW_CIRCLE_BR, color);
-}
-
-void GUI_DRAW_Triangle(const GUI_Display_t* disp, GUI_iDim_t x1, GUI_iDim_t y1,  GUI_iDim_t x2, GUI_iDim_t y2, GUI_iDim_t x3, GUI_iDim_t y3, GUI_Color_t color) {
-    GUI_DRAW_Line(disp, x1, y1, x2, y2, color);
-    GUI_DRAW_Line(disp, x1, y1, x3, y3, color);
-    GUI_DRAW_Line(disp, x2, y2, x3, y3, color);
+void GUI_DRAW_FilledRoundedRectangleAA(const GUI_Display_t* disp, GUI_iDim_t x, GUI_iDim_t y, GUI_iDim_t width, GUI_iDim_t height, GUI_iDim_t r, GUI_Color_t color) {
+    __SpanRect_t rect = {0};
+    GUI_iDim_t lines, line, i, j, cx, cy;
+    GUI_Color_t c;
+    uint8_t corner, *mask;
+    
+    r = __GUI_MIN(r, __GUI_MIN(width, height) / 2);
+    if (r <= 0 || r > __MASK_SIZE) {                /* Corner line must fit to mask buffer */
+        GUI_DRAW_FilledRoundedRectangle(disp, x, y, width, height, r, color);
+        return;
+    }
+    if (__IsClipEmpty(disp) || !__GUI_RECT_MATCH(
+        disp->X1, disp->Y1, disp->X2 - 1, disp->Y2 - 1,
+        x, y, x + width - 1, y + height - 1
+    )) {
+        return;
+    }
+    
+    /* Fill solid parts between corners */
+    c = __SpanColor(&rect, color);
+    if (width > 2 * r) {
+        __AddSpan_LCD(disp, &rect, x + r, y, width - 2 * r, r, c);
+        __AddSpan_LCD(disp, &rect, x + r, y + height - r, width - 2 * r, r, c);
+    }
+    if (height > 2 * r) {
+        __AddSpan_LCD(disp, &rect, x, y + r, width, height - 2 * r, c);
+    }
+    __AddSpan_LCD(disp, &rect, 0, 0, 0, 0, c);      /* Fill last rectangle */
+    
+    /* Blend corners as A8 masks, corner is processed in bands of lines when it does not fit to mask buffer */
+    lines = __MASK_SIZE / r;
+    for (line = 0; line < r; line += lines) {
+        lines = __GUI_MIN(lines, r - line);
+        for (corner = 0; corner < 4; corner++) {    /* Top left, top right, bottom left, bottom right */
+            cx = (corner & 0x01) ? x + width - r : x;
+            cy = ((corner & 0x02) ? y + height - r : y) + line;
+            if (!__GUI_RECT_MATCH(
+                disp->X1, disp->Y1, disp->X2 - 1, disp->Y2 - 1,
+                cx, cy, cx + r - 1, cy + lines - 1
+            )) {
+                continue;
+            }
+            mask = Masks[MaskIndex];                /* Use buffers alternately, hardware may still read previous one */
+            for (j = 0; j < lines; j++) {
+                for (i = 0; i < r; i++) {
+                    *mask++ = __CircleCoverage(
+                        (corner & 0x01) ? 2 * i + 1 : 2 * (r - i) - 1,
+                        (corner & 0x02) ? 2 * (line + j) + 1 : 2 * (r - line - j) - 1,
+                        r
+                    );
+                }
+            }
+            if (__GUI_DRAW_CopyConvert(disp, cx, cy, r, lines, Masks[MaskIndex], GUI_PixelFormat_A8, 0, color, color >> 24, 1)) {
+                MaskIndex = !MaskIndex;
+            }
+        }
+    }
 }
 
-void GUI_DRAW_FilledTriangle(const GUI_Display_t* disp, GUI_iDim_t x1, GUI_iDim_t y1, GUI_iDim_t x2, GUI_iDim_t y2, GUI_iDim_t x3, GUI_iDim_t y3, GUI_Color_t color) {
-    GUI_iDim_t deltax = 0, deltay = 0, x = 0, y = 0, xinc1 = 0, xinc2 = 0, 
-    yinc1 = 0, yinc2 = 0, den = 0, num = 0, numadd = 0, numpixels = 0, 
-    curpixel = 0;
+void GUI_DRAW_GradientRectangle(const GUI_Display_t* disp, GUI_iDim_t x, GUI_iDim_t y, GUI_iDim_t width, GUI_iDim_t height, const GUI_Gradient_t* gradient, GUI_DRAW_Gradient_t type, uint8_t dither) {
+    __FillGradient(disp, x, y, width, height, 0, gradient, type, dither);
+}
 
-    deltax = __GUI_ABS(x2 - x1);
-    deltay = __GUI_ABS(y2 - y1);
-    x = x1;
-    y = y1;
+void GUI_DRAW_GradientRoundedRectangle(const GUI_Display_t* disp, GUI_iDim_t x, GUI_iDim_t y, GUI_iDim_t width, GUI_iDim_t height, GUI_iDim_t r, const GUI_Gradient_t* gradient, GUI_DRAW_Gradient_t type, uint8_t dither) {
+    if (r >= (height / 2)) {
+        r = height / 2 - 1;
+    }
+    if (r >= (width / 2)) {
+        r = width / 2 - 1;
+    }
+    __FillGradient(disp, x, y, width, height, __GUI_MAX(r, 0), gradient, type, dither);
+}
 
-    if (x2 >= x1) {
-        xinc1 = 1;
-        xinc2 = 1;
-    } else {
-        xinc1 = -1;
-        xinc2 = -1;
+void GUI_DRAW_Circle(const GUI_Display_t* disp, GUI_iDim_t x, GUI_iDim_t y, GUI_iDim_t r, GUI_Color_t color) {
+    GUI_DRAW_CircleCorner(disp, x, y, r, GUI_DRAW_CIRCLE_TL, color);
+    GUI_DRAW_CircleCorner(disp, x - 1, y, r, GUI_DRAW_CIRCLE_TR, color);
+    GUI_DRAW_CircleCorner(disp, x, y - 1, r, GUI_DRAW_CIRCLE_BL, color);
+    GUI_DRAW_CircleCorner(disp, x - 1, y - 1, r, GUI_DRAW_CIRCLE_BR, color);
+}
+
+void GUI_DRAW_FilledCircle(const GUI_Display_t* disp, GUI_iDim_t x, GUI_iDim_t y, GUI_iDim_t r, GUI_Color_t color) {
+    if (r > 0) {
+        __FillRoundRect(disp, x - r, y - r, 2 * r, 2 * r, r, color);
     }
+}
 
-    if (y2 >= y1) {
-        yinc1 = 1;
-        yinc2 = 1;
-    } else {
-        yinc1 = -1;
-        yinc2 = -1;
+void GUI_DRAW_FilledCircleAA(const GUI_Display_t* disp, GUI_iDim_t x, GUI_iDim_t y, GUI_iDim_t r, GUI_Color_t color) {
+    GUI_DRAW_FilledRoundedRectangleAA(disp, x - r, y - r, 2 * r, 2 * r, r, color);
+}
+
+/* Fill part of ring between inner and outer radius from start angle to end angle, pie is filled when inner radius is negative */
+/* Angles are in degrees clockwise from positive X axis. Each line is split to spans by ring hole and two half-planes of start and end rays */
+static
+void __FillArc(const GUI_Display_t* disp, GUI_iDim_t x0, GUI_iDim_t y0, GUI_iDim_t r, GUI_iDim_t inner, int32_t start, int32_t end, GUI_Color_t color) {
+    __SpanRect_t rect = {0};
+    int32_t sweep, sx, sy, ex, ey, dy, yMin, yMax, ri;
+    uint32_t o2 = (uint32_t)r * r + r, i2 = (uint32_t)inner * inner + inner;   /* Pixel centers inside r * (r + 1) are inside circle */
+    GUI_iDim_t ring[2][2], ang[2][2], xo, xi, lo, hi;
+    uint8_t nr, na, i, k;
+    GUI_Color_t c;
+    
+    sweep = end - start;
+    if (r <= 0 || sweep <= 0 || __IsClipEmpty(disp) || !__GUI_RECT_MATCH(
+        disp->X1, disp->Y1, disp->X2 - 1, disp->Y2 - 1,
+        x0 - r, y0 - r, x0 + r, y0 + r
+    )) {
+        return;
+    }
+    sx = __Sin(start + 90);                         /* Direction vectors of start and end rays */
+    sy = __Sin(start);
+    ex = __Sin(end + 90);
+    ey = __Sin(end);
+    
+    /* Lines between ray end points, extended to top and bottom when sweep includes them */
+    ri = __GUI_MAX(inner, 0);
+    yMin = __GUI_MIN(__GUI_MIN(sy * r, ey * r), __GUI_MIN(sy * ri, ey * ri)) / 0x4000 - 1;
+    yMax = __GUI_MAX(__GUI_MAX(sy * r, ey * r), __GUI_MAX(sy * ri, ey * ri)) / 0x4000 + 1;
+    if (sweep >= 360 || ((270 - start) % 360 + 360) % 360 <= sweep) {
+        yMin = -r;
     }
+    if (sweep >= 360 || ((90 - start) % 360 + 360) % 360 <= sweep) {
+        yMax = r;
+    }
+    yMin = __GUI_MAX(yMin, __GUI_MAX(-r, disp->Y1 - y0));
+    yMax = __GUI_MIN(yMax, __GUI_MIN(r, disp->Y2 - 1 - y0));
+    
+    c = __SpanColor(&rect, color);
+    for (dy = yMin; dy <= yMax; dy++) {
+        if ((uint32_t)(dy * dy) > o2) {
+            continue;
+        }
+        xo = __Sqrt(o2 - dy * dy);
+        nr = 1;                                     /* Spans of ring on this line */
+        ring[0][0] = -xo;
+        ring[0][1] = xo;
+        if (inner >= 0 && (uint32_t)(dy * dy) <= i2) {  /* Line crosses ring hole */
+            xi = __Sqrt(i2 - dy * dy);
+            ring[0][1] = -xi - 1;
+            ring[1][0] = xi + 1;
+            ring[1][1] = xo;
+            nr = 2;
+        }
+        
+        na = 1;                                     /* Spans inside angle range */
+        ang[0][0] = -0x7FFF;
+        ang[0][1] = 0x7FFF;
+        if (sweep < 360) {
+            __HalfPlane(sx, sy, dy, &ang[0][0], &ang[0][1]);    /* Half turn clockwise from start ray */
+            __HalfPlane(-ex, -ey, dy, &ang[1][0], &ang[1][1]);  /* Half turn counter-clockwise from end ray */
+            if (sweep <= 180) {                     /* Intersection of half-planes */
+                ang[0][0] = __GUI_MAX(ang[0][0], ang[1][0]);
+                ang[0][1] = __GUI_MIN(ang[0][1], ang[1][1]);
+            } else if (ang[0][0] > ang[0][1]) {     /* Union of half-planes, first one is empty */
+                ang[0][0] = ang[1][0];
+                ang[0][1] = ang[1][1];
+            } else if (ang[1][0] <= ang[1][1]) {
+                if (__GUI_MAX(ang[0][0], ang[1][0]) <= __GUI_MIN(ang[0][1], ang[1][1]) + 1) {
+                    ang[0][0] = __GUI_MIN(ang[0][0], ang[1][0]);    /* Overlapping ranges are merged */
+                    ang[0][1] = __GUI_MAX(ang[0][1], ang[1][1]);
+                } else {
+                    na = 2;
+                }
+            }
+        }
+        
+        for (i = 0; i < nr; i++) {
+            for (k = 0; k < na; k++) {
+                lo = __GUI_MAX(ring[i][0], ang[k][0]);
+                hi = __GUI_MIN(ring[i][1], ang[k][1]);
+                if (lo <= hi) {
+                    __AddSpan_LCD(disp, &rect, x0 + lo, y0 + dy, hi - lo + 1, 1, c);
+                }
+            }
+        }
+        if (!dy && inner < 0 && sweep < 360 && (360 - start % 360) % 360 < sweep) {
+            __AddSpan_LCD(disp, &rect, x0, y0, 1, 1, c);    /* Pie center belongs to part containing angle 0 */
+        }
+    }
+    __AddSpan_LCD(disp, &rect, 0, 0, 0, 0, c);      /* Fill last rectangle */
+}
 
-    if (deltax >= deltay){
-        xinc1 = 0;
-        yinc2 = 0;
-        den = deltax;
-        num = deltax / 2;
-        numadd = deltay;
-        numpixels = deltax;
-    } else {
-        xinc2 = 0;
-        yinc1 = 0;
-        den = deltay;
-        num = deltay / 2;
-        numadd = deltax;
-        numpixels = deltay;
+void GUI_DRAW_Arc(const GUI_Display_t* disp, GUI_iDim_t x0, GUI_iDim_t y0, GUI_iDim_t r, int16_t start, int16_t end, GUI_Color_t color) {
+    __FillArc(disp, x0, y0, r, r - 1, start, end, color);
+}
+
+void GUI_DRAW_FilledPie(const GUI_Display_t* disp, GUI_iDim_t x0, GUI_iDim_t y0, GUI_iDim_t r, int16_t start, int16_t end, GUI_Color_t color) {
+    __FillArc(disp, x0, y0, r, -1, start, end, color);
+}
+
+void GUI_DRAW_Ring(const GUI_Display_t* disp, GUI_iDim_t x0, GUI_iDim_t y0, GUI_iDim_t r, GUI_iDim_t width, int16_t start, int16_t end, GUI_Color_t color) {
+    if (width > 0) {
+        __FillArc(disp, x0, y0, r, __GUI_MAX(r - width, -1), start, end, color);
     }
+}
 
-    for (curpixel = 0; curpixel <= numpixels; curpixel++) {
-        GUI_DRAW_Line(disp, x, y, x3, y3, color);
+void GUI_DRAW_Triangle(const GUI_Display_t* disp, GUI_iDim_t x1, GUI_iDim_t y1,  GUI_iDim_t x2, GUI_iDim_t y2, GUI_iDim_t x3, GUI_iDim_t y3, GUI_Color_t color) {
+    GUI_DRAW_Line(disp, x1, y1, x2, y2, color);
+    GUI_DRAW_Line(disp, x1, y1, x3, y3, color);
+    GUI_DRAW_Line(disp, x2, y2, x3, y3, color);
+}
 
-        num += numadd;
-        if (num >= den) {
-            num -= den;
-            x += xinc1;
-            y += yinc1;
+/* Fill polygon with pixel corners as coordinates, pixels with center on left edge are skipped when "open" is set */
+static
+void __FillPoly(const GUI_Display_t* disp, const GUI_DRAW_Poly_t* points, uint32_t count, GUI_DRAW_FillRule_t rule, uint8_t open, GUI_Color_t color) {
+    __PolyEdge_t *edges = PolyEdges, **active = PolyActive, *e;
+    __SpanRect_t rect = {0};
+    GUI_iDim_t minX, minY, maxX, maxY, y, xs = 0;
+    uint32_t i, k, n = 0, next = 0, act = 0;
+    int32_t x, winding;
+    
+    if (count < 3) {
+        return;
+    }
+    minX = maxX = points[0].X;
+    minY = maxY = points[0].Y;
+    for (i = 1; i < count; i++) {                   /* Get bounding rectangle */
+        minX = __GUI_MIN(minX, points[i].X);
+        maxX = __GUI_MAX(maxX, points[i].X);
+        minY = __GUI_MIN(minY, points[i].Y);
+        maxY = __GUI_MAX(maxY, points[i].Y);
+    }
+    if (__IsClipEmpty(disp) || maxX < disp->X1 || minX >= disp->X2 || maxY <= disp->Y1 || minY >= disp->Y2) {
+        return;
+    }
+    minY = __GUI_MAX(minY, disp->Y1);               /* Visible scanlines */
+    maxY = __GUI_MIN(maxY, disp->Y2);
+    
+    if (count > __POLY_EDGES) {                     /* Too many edges for static buffers */
+        active = (__PolyEdge_t **)__GUI_MEMALLOC(count * (sizeof(*active) + sizeof(*edges)));
+        if (!active) {
+            return;
         }
-        x += xinc2;
-        y += yinc2;
+        edges = (__PolyEdge_t *)&active[count];
     }
+    
+    /* Build edge table sorted by first visible scanline, horizontal and invisible edges are ignored */
+    for (i = 0; i < count; i++) {
+        const GUI_DRAW_Poly_t *p1 = &points[i], *p2 = &points[(i + 1) % count];
+        if (p1->Y == p2->Y || __GUI_MAX(p1->Y, p2->Y) <= minY || __GUI_MIN(p1->Y, p2->Y) >= maxY) {
+            continue;
+        }
+        __PolyEdgeInit(&edges[n], p1->X, p1->Y, p2->X, p2->Y, __GUI_MAX(__GUI_MIN(p1->Y, p2->Y), minY));
+        for (k = n++; k > 0 && edges[k - 1].Y1 > edges[k].Y1; k--) {
+            __PolyEdge_t tmp = edges[k];
+            edges[k] = edges[k - 1];
+            edges[k - 1] = tmp;
+        }
+    }
+    
+    color = __SpanColor(&rect, color);              /* Convert color once for all spans */
+    for (y = minY; y < maxY; y++) {
+        for (i = 0, k = 0; i < act; i++) {          /* Remove finished edges */
+            if (active[i]->Y2 > y) {
+                active[k++] = active[i];
+            }
+        }
+        act = k;
+        while (next < n && edges[next].Y1 == y) {   /* Add edges starting on this scanline */
+            active[act++] = &edges[next++];
+        }
+        for (i = 1; i < act; i++) {                 /* Sort by crossing, order changes only on edge crossings */
+            for (k = i; k > 0 && (active[k - 1]->X + (active[k - 1]->Rem > 0)) > (active[k]->X + (active[k]->Rem > 0)); k--) {
+                e = active[k];
+                active[k] = active[k - 1];
+                active[k - 1] = e;
+            }
+        }
+        
+        /* Draw spans between crossings, pixel is inside when its center is right of left crossing and left of right crossing */
+        winding = 0;
+        for (i = 0; i < act; i++) {
+            e = active[i];
+            x = e->X + (e->Rem > 0);
+            if (rule == GUI_DRAW_FillRule_EvenOdd) {
+                winding = !winding;
+            } else {
+                winding += e->Dir;
+            }
+            if (winding && (rule == GUI_DRAW_FillRule_EvenOdd || winding == e->Dir)) {  /* Span starts */
+                xs = x + (open && !e->Rem);
+            } else if (!winding && x > xs) {       /* Span ends */
+                __AddSpan_LCD(disp, &rect, xs, y, x - xs, 1, color);
+            }
+            
+            e->X += e->StepX;                       /* Move crossing to next scanline */
+            e->Rem += e->StepRem;
+            if (e->Rem >= e->Den) {
+                e->Rem -= e->Den;
+                e->X++;
+            }
+        }
+    }
+    __AddSpan_LCD(disp, &rect, 0, 0, 0, 0, color);  /* Fill last rectangle */
+    
+    if (active != PolyActive) {
+        __GUI_MEMFREE(active);
+    }
+}
+
+/* Get cross product of vectors from "o" to "a" and from "o" to "b" */
+static
+int64_t __Cross(const GUI_DRAW_Poly_t* o, const GUI_DRAW_Poly_t* a, const GUI_DRAW_Poly_t* b) {
+    return (int64_t)(a->X - o->X) * (b->Y - o->Y) - (int64_t)(a->Y - o->Y) * (b->X - o->X);
+}
+
+void GUI_DRAW_FilledTriangle(const GUI_Display_t* disp, GUI_iDim_t x1, GUI_iDim_t y1, GUI_iDim_t x2, GUI_iDim_t y2, GUI_iDim_t x3, GUI_iDim_t y3, GUI_Color_t color) {
+    GUI_DRAW_Poly_t corners[12], hull[24], tmp;
+    GUI_iDim_t x[3], y[3];
+    uint32_t i, k, n = 0;
+    
+    x[0] = x1, x[1] = x2, x[2] = x3;
+    y[0] = y1, y[1] = y2, y[2] = y3;
+    for (i = 0; i < 12; i++) {                      /* Corners of pixels at vertices, sorted by X then Y */
+        corners[i].X = x[i / 4] + (i & 1);
+        corners[i].Y = y[i / 4] + ((i >> 1) & 1);
+        for (k = i; k > 0 && (corners[k - 1].X > corners[k].X || (corners[k - 1].X == corners[k].X && corners[k - 1].Y > corners[k].Y)); k--) {
+            tmp = corners[k];
+            corners[k] = corners[k - 1];
+            corners[k - 1] = tmp;
+        }
+    }
+    
+    /* Convex hull of corners covers all pixels closer than half pixel to triangle, including its outline */
+    for (i = 0; i < 12; i++) {                      /* Lower part */
+        while (n >= 2 && __Cross(&hull[n - 2], &hull[n - 1], &corners[i]) <= 0) {
+            n--;
+        }
+        hull[n++] = corners[i];
+    }
+    for (i = 11, k = n + 1; i-- > 0;) {             /* Upper part */
+        while (n >= k && __Cross(&hull[n - 2], &hull[n - 1], &corners[i]) <= 0) {
+            n--;
+        }
+        hull[n++] = corners[i];
+    }
+    __FillPoly(disp, hull, n - 1, GUI_DRAW_FillRule_EvenOdd, 1, color);   /* Last point is the same as first */
+}
+
+void GUI_DRAW_FilledPoly(const GUI_Display_t* disp, const GUI_DRAW_Poly_t* points, uint32_t count, GUI_DRAW_FillRule_t rule, GUI_Color_t color) {
+    __FillPoly(disp, points, count, rule, 0, color);
 }
 
 void GUI_DRAW_CircleCorner(const GUI_Display_t* disp, GUI_iDim_t x0, GUI_iDim_t y0, GUI_iDim_t r, GUI_Byte_t c, GUI_Color_t color) {
@@ -586,12 +2196,13 @@ void GUI_DRAW_CircleCorner(const GUI_Display_t* disp, GUI_iDim_t x0, GUI_iDim_t
     GUI_iDim_t x = 0;
     GUI_iDim_t y = r;
     
-    if (!__GUI_RECT_MATCH(
+    if (__IsClipEmpty(disp) || !__GUI_RECT_MATCH(
         disp->X1, disp->Y1, disp->X2, disp->Y2,
         x0 - r, y0 - r, x0 + r, y0 + r
     )) {
         return;
     }
+    color = __GUI_DRAW_ColorToLCD(color);           /* Convert color once for all pixels */
 
     while (x < y) {
         if (f >= 0) {
@@ -604,68 +2215,57 @@ void GUI_DRAW_CircleCorner(const GUI_Display_t* disp, GUI_iDim_t x0, GUI_iDim_t
         f += ddF_x;
 
         if (c & GUI_DRAW_CIRCLE_TL) {               /* Top left corner */
-            GUI_DRAW_SetPixel(disp, x0 - y, y0 - x, color);
-            GUI_DRAW_SetPixel(disp, x0 - x, y0 - y, color);
+            __SetPixel_LCD(disp, x0 - y, y0 - x, color);
+            __SetPixel_LCD(disp, x0 - x, y0 - y, color);
         }
 
         if (c & GUI_DRAW_CIRCLE_TR) {               /* Top right corner */
-            GUI_DRAW_SetPixel(disp, x0 + x, y0 - y, color);
-            GUI_DRAW_SetPixel(disp, x0 + y, y0 - x, color);
+            __SetPixel_LCD(disp, x0 + x, y0 - y, color);
+            __SetPixel_LCD(disp, x0 + y, y0 - x, color);
         }
 
         if (c & GUI_DRAW_CIRCLE_BR) {               /* Bottom right corner */
-            GUI_DRAW_SetPixel(disp, x0 + x, y0 + y, color);
-            GUI_DRAW_SetPixel(disp, x0 + y, y0 + x, color);
+            __SetPixel_LCD(disp, x0 + x, y0 + y, color);
+            __SetPixel_LCD(disp, x0 + y, y0 + x, color);
         }
 
         if (c & GUI_DRAW_CIRCLE_BL) {               /* Bottom left corner */
-            GUI_DRAW_SetPixel(disp, x0 - x, y0 + y, color);
-            GUI_DRAW_SetPixel(disp, x0 - y, y0 + x, color);
+            __SetPixel_LCD(disp, x0 - x, y0 + y, color);
+            __SetPixel_LCD(disp, x0 - y, y0 + x, color);
         }
     }
 }
 
 void GUI_DRAW_FilledCircleCorner(const GUI_Display_t* disp, GUI_iDim_t x0, GUI_iDim_t y0, GUI_iDim_t r, GUI_Byte_t c, GUI_Color_t color) {
-    GUI_iDim_t f = 1 - r;
-    GUI_iDim_t ddF_x = 1;
-    GUI_iDim_t ddF_y = -2 * r;
-    GUI_iDim_t x = 0;
-    GUI_iDim_t y = r;
+    __SpanRect_t rect = {0};
+    GUI_iDim_t* ext;
+    GUI_iDim_t k, x1, x2;
     
-    if (!__GUI_RECT_MATCH(
+    if (__IsClipEmpty(disp) || !__GUI_RECT_MATCH(
         disp->X1, disp->Y1, disp->X2, disp->Y2,
         x0 - r, y0 - r, x0 + r, y0 + r
-    )) {
+    ) || !(ext = __CircleExtents(r))) {
         return;
     }
-
-    while (x < y) {
-        if (f >= 0) {
-            y--;
-            ddF_y += 2;
-            f += ddF_y;
-        }
-        x++;
-        ddF_x += 2;
-        f += ddF_x;
-
-        if (c & GUI_DRAW_CIRCLE_TL) {               /* Top left */            
-            GUI_DRAW_HLine(disp, x0 - x, y0 - y, x, color);
-            GUI_DRAW_HLine(disp, x0 - y, y0 - x, y, color);
-        }
-        if (c & GUI_DRAW_CIRCLE_TR) {               /* Top right */
-            GUI_DRAW_HLine(disp, x0, y0 - y, x, color);
-            GUI_DRAW_HLine(disp, x0, y0 - x, y, color);
-        }
-        if (c & GUI_DRAW_CIRCLE_BL) {               /* Bottom left */
-            GUI_DRAW_HLine(disp, x0 - y, y0 + x, y, color);
-            GUI_DRAW_HLine(disp, x0 - x, y0 + y, x, color);
+    color = __SpanColor(&rect, color);              /* Convert color once for all lines */
+    
+    /* Left and right corners on the same line are drawn as single span */
+    if (c & (GUI_DRAW_CIRCLE_TL | GUI_DRAW_CIRCLE_TR)) {
+        for (k = r; k > 0; k--) {
+            x1 = (c & GUI_DRAW_CIRCLE_TL) ? x0 - ext[k] : x0;
+            x2 = (c & GUI_DRAW_CIRCLE_TR) ? x0 + ext[k] : x0;
+            __AddSpan_LCD(disp, &rect, x1, y0 - k, x2 - x1, 1, color);
         }
-        if (c & GUI_DRAW_CIRCLE_BR) {               /* Bottom right */
-            GUI_DRAW_HLine(disp, x0, y0 + x, y, color);
-            GUI_DRAW_HLine(disp, x0, y0 + y, x, color);
+    }
+    if (c & (GUI_DRAW_CIRCLE_BL | GUI_DRAW_CIRCLE_BR)) {
+        for (k = 1; k <= r; k++) {
+            x1 = (c & GUI_DRAW_CIRCLE_BL) ? x0 - ext[k] : x0;
+            x2 = (c & GUI_DRAW_CIRCLE_BR) ? x0 + ext[k] : x0;
+            __AddSpan_LCD(disp, &rect, x1, y0 + k, x2 - x1, 1, color);
         }
     }
+    __AddSpan_LCD(disp, &rect, 0, 0, 0, 0, color);  /* Fill last rectangle */
+    __CircleExtentsFree(ext);
 }
 
 void GUI_DRAW_Poly(const GUI_Display_t* disp, const GUI_DRAW_Poly_t* points, GUI_Byte len, GUI_Color_t color) {
@@ -685,6 +2285,484 @@ void GUI_DRAW_Poly(const GUI_Display_t* disp, const GUI_DRAW_Poly_t* points, GUI
     }
 }
 
+void GUI_DRAW_LineAA(const GUI_Display_t* disp, GUI_iDim_t x1, GUI_iDim_t y1, GUI_iDim_t x2, GUI_iDim_t y2, GUI_Color_t color) {
+    __LineAA(disp, x1, y1, x2, y2, color, 1);
+}
+
+void GUI_DRAW_PolyLineAA(const GUI_Display_t* disp, const GUI_DRAW_Poly_t* points, uint32_t count, GUI_Color_t color) {
+    if (count == 1) {
+        __LineAA(disp, points->X, points->Y, points->X, points->Y, color, 1);
+    }
+    for (; count > 1; count--, points++) {          /* Shared points are drawn by next line only */
+        __LineAA(disp, points[0].X, points[0].Y, points[1].X, points[1].Y, color, count == 2);
+    }
+}
+
+/* Round pixel center moved by offset in 1/256 pixels to nearest pixel corner */
+static
+GUI_iDim_t __StrokeCorner(GUI_iDim_t p, int32_t off) {
+    int32_t q, r;
+    
+    __FloorDiv(off, 256, &q, &r);
+    return p + 1 + q;
+}
+
+/* Get corners of line with width between pixel centers, ends are extended by "ext1" and "ext2" in 1/256 pixels */
+/* First two corners are on the same side of line, corner 1 and 2 are at the end point */
+static
+void __StrokeQuad(GUI_iDim_t x1, GUI_iDim_t y1, GUI_iDim_t x2, GUI_iDim_t y2, GUI_iDim_t width, int32_t ext1, int32_t ext2, GUI_DRAW_Poly_t* q) {
+    int32_t dx = x2 - x1, dy = y2 - y1, len, ux, uy, nx, ny;
+    
+    while (dx >= 2048 || dx <= -2048 || dy >= 2048 || dy <= -2048) {   /* Only direction is needed */
+        dx /= 2;
+        dy /= 2;
+    }
+    len = __Sqrt((uint32_t)(dx * dx + dy * dy) << 8);  /* Length in 1/16 pixels */
+    ux = dx * 65536 / len;                          /* Unit direction in Q12 */
+    uy = dy * 65536 / len;
+    nx = -uy * width / 32;                          /* Half width normal in 1/256 pixels */
+    ny = ux * width / 32;
+    
+    q[0].X = __StrokeCorner(x1, nx - ux * ext1 / 4096);
+    q[0].Y = __StrokeCorner(y1, ny - uy * ext1 / 4096);
+    q[1].X = __StrokeCorner(x2, nx + ux * ext2 / 4096);
+    q[1].Y = __StrokeCorner(y2, ny + uy * ext2 / 4096);
+    q[2].X = __StrokeCorner(x2, -nx + ux * ext2 / 4096);
+    q[2].Y = __StrokeCorner(y2, -ny + uy * ext2 / 4096);
+    q[3].X = __StrokeCorner(x1, -nx - ux * ext1 / 4096);
+    q[3].Y = __StrokeCorner(y1, -ny - uy * ext1 / 4096);
+}
+
+/* Get "num / den" rounded to nearest integer, "den" must be positive */
+static
+int32_t __RoundDiv(int64_t num, int64_t den) {
+    num = 2 * num + den;
+    den *= 2;
+    return (int32_t)(num / den - (num % den < 0));
+}
+
+/* Check if all corners of line quadrilateral turn in the same direction as corners from __StrokeQuad */
+static
+uint8_t __StrokeQuadValid(const GUI_DRAW_Poly_t* q) {
+    uint8_t k;
+    
+    for (k = 0; k < 4; k++) {
+        if (__Cross(&q[k], &q[(k + 1) & 3], &q[(k + 2) & 3]) > 0) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+/* Join line "a" with next line "b" at point "p", returns 1 when bevel triangle on outer side must be drawn */
+/* Inner corners are moved to crossing of inner edges, so lines and bevel share edges and no pixel is drawn twice */
+static
+uint8_t __StrokeJoin(const GUI_DRAW_Poly_t* p, GUI_DRAW_Poly_t* a, GUI_DRAW_Poly_t* b, GUI_DRAW_Poly_t* tri) {
+    GUI_DRAW_Poly_t sa[4], sb[4];
+    int64_t cross, den, t, u;
+    int32_t rx, ry, sx, sy, qx, qy;
+    uint8_t is, ie, oa, ob;
+    
+    rx = a[1].X - a[0].X, ry = a[1].Y - a[0].Y;     /* Line directions */
+    sx = b[1].X - b[0].X, sy = b[1].Y - b[0].Y;
+    cross = (int64_t)rx * sy - (int64_t)ry * sx;
+    if (!cross) {                                   /* Same or opposite direction */
+        if ((int64_t)rx * sx + (int64_t)ry * sy > 0) {
+            b[0] = a[1];                            /* Continue with the same edge */
+            b[3] = a[2];
+        }
+        return 0;
+    }
+    
+    /* Line turns towards normal side of corners 0 and 1 when cross product is positive */
+    is = cross > 0 ? 0 : 3;                         /* Inner corners at start and end of line */
+    ie = cross > 0 ? 1 : 2;
+    oa = cross > 0 ? 2 : 1;                         /* Outer corner at end of "a" */
+    ob = cross > 0 ? 3 : 0;                         /* Outer corner at start of "b" */
+    memcpy(sa, a, sizeof(sa));
+    memcpy(sb, b, sizeof(sb));
+    
+    /* Crossing of inner edges must not be before start of "a" or after end of "b" */
+    rx = a[ie].X - a[is].X, ry = a[ie].Y - a[is].Y;
+    sx = b[ie].X - b[is].X, sy = b[ie].Y - b[is].Y;
+    qx = b[is].X - a[is].X, qy = b[is].Y - a[is].Y;
+    den = (int64_t)rx * sy - (int64_t)ry * sx;
+    t = (int64_t)qx * sy - (int64_t)qy * sx;
+    u = (int64_t)qx * ry - (int64_t)qy * rx;
+    if (den < 0) {
+        den = -den, t = -t, u = -u;
+    }
+    if (!den || (t >= 0 && u <= den)) {
+        if (den && t <= den && u >= 0) {            /* Move corner to crossing, edges of small angles may miss it because of rounding */
+            a[ie].X = a[is].X + __RoundDiv(rx * t, den);
+            a[ie].Y = a[is].Y + __RoundDiv(ry * t, den);
+        }
+        b[is] = a[ie];
+        if ((__Cross(&a[ie], &a[oa], &b[ob]) > 0) != (cross > 0)) {
+            b[ob] = a[oa];                          /* Bevel is too small, share outer edge */
+        }
+        if (__StrokeQuadValid(a) && __StrokeQuadValid(b)) {
+            tri[0] = a[ie];
+            tri[1] = a[oa];
+            tri[2] = b[ob];
+            return b[ob].X != a[oa].X || b[ob].Y != a[oa].Y;
+        }
+        memcpy(a, sa, sizeof(sa));                  /* Lines are too short, keep them overlapped */
+        memcpy(b, sb, sizeof(sb));
+    }
+    tri[0].X = __StrokeCorner(p->X, 0);             /* Cover gap between outer corners only */
+    tri[0].Y = __StrokeCorner(p->Y, 0);
+    tri[1] = a[oa];
+    tri[2] = b[ob];
+    return 1;
+}
+
+/* Draw thick lines through points, lines are joined with bevel */
+/* Each line is drawn after join at its end is known, first line of closed polygon is drawn last */
+static
+void __StrokePoly(const GUI_Display_t* disp, const GUI_DRAW_Poly_t* points, uint32_t count, GUI_iDim_t width, int32_t ext, uint8_t closed, GUI_Color_t color) {
+    GUI_DRAW_Poly_t first[4], prev[4], cur[4], tri[3];
+    const GUI_DRAW_Poly_t *p1, *p2;
+    uint32_t i, last, segs = 0;
+    
+    if (!count || width <= 0 || __IsClipEmpty(disp)) {
+        return;
+    }
+    for (last = count - 1; last > 0 && points[last - 1].X == points[last].X && points[last - 1].Y == points[last].Y; last--);
+    for (i = 0; i < (closed ? count : last); i++) {
+        p1 = &points[i];
+        p2 = &points[(i + 1) % count];
+        if (p1->X == p2->X && p1->Y == p2->Y) {     /* Ignore repeated points */
+            continue;
+        }
+        if (width == 1) {
+            GUI_DRAW_Line(disp, p1->X, p1->Y, p2->X, p2->Y, color);
+            segs++;
+            continue;
+        }
+        __StrokeQuad(p1->X, p1->Y, p2->X, p2->Y, width, closed || segs ? 0 : ext, closed || i + 1 < last ? 0 : ext, cur);
+        if (segs++) {
+            if (__StrokeJoin(p1, prev, cur, tri)) {
+                GUI_DRAW_FilledPoly(disp, tri, 3, GUI_DRAW_FillRule_EvenOdd, color);
+            }
+            if (closed && segs == 2) {              /* Start of first line changes with closing join */
+                memcpy(first, prev, sizeof(first));
+            } else {
+                GUI_DRAW_FilledPoly(disp, prev, 4, GUI_DRAW_FillRule_EvenOdd, color);
+            }
+        }
+        memcpy(prev, cur, sizeof(prev));
+    }
+    if (!segs) {                                    /* All points are the same, draw square */
+        GUI_DRAW_Fill(disp, points->X - (width - 1) / 2, points->Y - (width - 1) / 2, width, width, color);
+    } else if (width > 1) {
+        if (closed && segs > 1) {
+            if (__StrokeJoin(points, prev, first, tri)) {
+                GUI_DRAW_FilledPoly(disp, tri, 3, GUI_DRAW_FillRule_EvenOdd, color);
+            }
+            GUI_DRAW_FilledPoly(disp, first, 4, GUI_DRAW_FillRule_EvenOdd, color);
+        }
+        GUI_DRAW_FilledPoly(disp, prev, 4, GUI_DRAW_FillRule_EvenOdd, color);
+    }
+}
+
+void GUI_DRAW_ThickLine(const GUI_Display_t* disp, GUI_iDim_t x1, GUI_iDim_t y1, GUI_iDim_t x2, GUI_iDim_t y2, GUI_iDim_t width, GUI_DRAW_LineCap_t cap, GUI_Color_t color) {
+    GUI_DRAW_Poly_t points[2];
+    
+    points[0].X = x1;
+    points[0].Y = y1;
+    points[1].X = x2;
+    points[1].Y = y2;
+    GUI_DRAW_ThickPolyLine(disp, points, 2, width, cap, color);
+}
+
+void GUI_DRAW_ThickPolyLine(const GUI_Display_t* disp, const GUI_DRAW_Poly_t* points, uint32_t count, GUI_iDim_t width, GUI_DRAW_LineCap_t cap, GUI_Color_t color) {
+    __StrokePoly(disp, points, count, width, cap == GUI_DRAW_LineCap_Square ? (int32_t)width * 128 : 128, 0, color);
+}
+
+void GUI_DRAW_ThickPoly(const GUI_Display_t* disp, const GUI_DRAW_Poly_t* points, uint32_t count, GUI_iDim_t width, GUI_Color_t color) {
+    __StrokePoly(disp, points, count, width, 0, 1, color);
+}
+
+void GUI_DRAW_ThickRectangle(const GUI_Display_t* disp, GUI_iDim_t x, GUI_iDim_t y, GUI_iDim_t width, GUI_iDim_t height, GUI_iDim_t stroke, GUI_Color_t color) {
+    if (width <= 0 || height <= 0 || stroke <= 0) {
+        return;
+    }
+    if (2 * stroke >= width || 2 * stroke >= height) {  /* Stroke covers whole rectangle */
+        GUI_DRAW_Fill(disp, x, y, width, height, color);
+        return;
+    }
+    GUI_DRAW_Fill(disp, x,                  y,                   width,  stroke,              color);
+    GUI_DRAW_Fill(disp, x,                  y + height - stroke, width,  stroke,              color);
+    GUI_DRAW_Fill(disp, x,                  y + stroke,          stroke, height - 2 * stroke, color);
+    GUI_DRAW_Fill(disp, x + width - stroke, y + stroke,          stroke, height - 2 * stroke, color);
+}
+
+void GUI_DRAW_ThickCircle(const GUI_Display_t* disp, GUI_iDim_t x0, GUI_iDim_t y0, GUI_iDim_t r, GUI_iDim_t width, GUI_Color_t color) {
+    GUI_DRAW_Ring(disp, x0, y0, r, width, 0, 360, color);
+}
+
+/* Read run header or raw pixel value of source data */
+static
+uint32_t __ReadRawPixel(const uint8_t* src, uint8_t size) {
+    switch (size) {
+        case 4:
+            return *(const uint32_t *)src;
+        case 2:
+            return *(const uint16_t *)src;
+        default:
+            return *src;
+    }
+}
+
+/* Decode run-length encoded image part, x and y are positions of part top left corner */
+/* Lines before visible area are skipped with line index when available, other lines and runs by reading headers only */
+static
+void __DrawImageRLE(const GUI_Display_t* disp, GUI_iDim_t x, GUI_iDim_t y, const GUI_IMAGE_DESC_t* img, GUI_iDim_t xOffset, GUI_iDim_t yOffset, GUI_iDim_t width, GUI_iDim_t height, GUI_Byte alpha, uint8_t blend) {
+    const uint8_t* s = (const uint8_t *)img->Data;
+    uint8_t size = __FormatPixelSize(img->Format);
+    uint32_t h, top = 1UL << (8 * size - 1), mask = size == 4 ? 0x00FFFFFFUL : 0xFFFFFFFFUL;
+    GUI_iDim_t i, k, len, x1, x2, y1, y2, start, end;
+    GUI_Color_t c, a;
+    
+    x1 = __GUI_MAX(xOffset, disp->X1 - x + xOffset);    /* Visible columns and lines of image */
+    x2 = __GUI_MIN(xOffset + width, disp->X2 - x + xOffset);
+    y1 = __GUI_MAX(yOffset, disp->Y1 - y + yOffset);
+    y2 = __GUI_MIN(yOffset + height, disp->Y2 - y + yOffset);
+    if (x1 >= x2 || y1 >= y2) {
+        return;
+    }
+    x -= xOffset;                                   /* Position of image top left corner */
+    y -= yOffset;
+    
+    i = 0;
+    if (img->LineIndex) {                           /* Start at closest indexed line above visible area */
+        i = y1 - y1 % GUI_IMAGE_RLE_INDEX_LINES;
+        s += size * img->LineIndex[i / GUI_IMAGE_RLE_INDEX_LINES];
+    }
+    for (; i < y2; i++) {
+        for (k = 0; k < img->Width; k += len, s += (h & top) ? size : size * len) {
+            h = __ReadRawPixel(s, size);
+            s += size;
+            len = (GUI_iDim_t)(h & (top - 1)) + 1;
+            start = __GUI_MAX(k, x1);
+            end = __GUI_MIN(k + len, x2);
+            if (i < y1 || start >= end) {           /* Run is not visible */
+                continue;
+            }
+            if (!(h & top)) {                       /* Copy visible pixels */
+                __GUI_DRAW_CopyConvert(disp, x + start, y + i, end - start, 1, &s[size * (start - k)], img->Format, 0, img->Color, alpha, blend);
+                continue;
+            }
+            if ((img->Flags & GUI_FLAG_IMAGE_COLORKEY) && (__ReadRawPixel(s, size) & mask) == (img->ColorKey & mask)) {
+                continue;                           /* Transparent run */
+            }
+            if (!blend && img->Format == GUI.LCD.PixelFormat) {
+                __HLine_LCD(disp, x + start, y + i, end - start, __Kernels()->GetPixel(s));
+                continue;
+            }
+            c = __ReadSourcePixel(s, img->Format, img->Color);
+            a = blend ? ((c >> 24) * alpha) / 255 : 0xFF; /* Combine pixel and global alpha */
+            if (a == 0xFF) {                        /* Opaque run */
+                __HLine_LCD(disp, x + start, y + i, end - start, __GUI_DRAW_ColorToLCD(c | 0xFF000000UL));
+            } else {
+                __FillBlend(disp, x + start, y + i, end - start, 1, (c & 0x00FFFFFFUL) | (a << 24));
+            }
+        }
+    }
+}
+
+void GUI_DRAW_Image(const GUI_Display_t* disp, GUI_iDim_t x, GUI_iDim_t y, const GUI_IMAGE_DESC_t* img, GUI_Byte alpha) {
+    GUI_DRAW_ImagePart(disp, x, y, img, 0, 0, img->Width, img->Height, alpha);
+}
+
+void GUI_DRAW_ImagePart(const GUI_Display_t* disp, GUI_iDim_t x, GUI_iDim_t y, const GUI_IMAGE_DESC_t* img, GUI_iDim_t xOffset, GUI_iDim_t yOffset, GUI_iDim_t width, GUI_iDim_t height, GUI_Byte alpha) {
+    const uint8_t* s;
+    uint8_t size = __FormatPixelSize(img->Format), blend;
+    GUI_iDim_t i, k, start, y1, y2;
+    uint32_t key, mask, p;
+    
+    if (xOffset < 0) {                              /* Keep part inside image */
+        x -= xOffset;
+        width += xOffset;
+        xOffset = 0;
+    }
+    if (yOffset < 0) {
+        y -= yOffset;
+        height += yOffset;
+        yOffset = 0;
+    }
+    width = __GUI_MIN(width, (GUI_iDim_t)img->Width - xOffset);
+    height = __GUI_MIN(height, (GUI_iDim_t)img->Height - yOffset);
+    if (width <= 0 || height <= 0 || !alpha || __IsClipEmpty(disp)) {
+        return;
+    }
+    
+    /* Image without alpha channel is converted only, others are blended over background */
+    blend = alpha != 0xFF || img->Format == GUI_PixelFormat_A8 ||
+        (img->Format == GUI_PixelFormat_ARGB8888 && !(img->Flags & GUI_FLAG_IMAGE_OPAQUE));
+    if (img->Flags & GUI_FLAG_IMAGE_RLE) {          /* Decode visible lines and columns only */
+        __DrawImageRLE(disp, x, y, img, xOffset, yOffset, width, height, alpha, blend);
+        return;
+    }
+    
+    s = (const uint8_t *)img->Data + size * ((uint32_t)yOffset * img->Width + xOffset);
+    
+    if (!(img->Flags & GUI_FLAG_IMAGE_COLORKEY)) {  /* Complete part is drawn with single operation */
+        __GUI_DRAW_CopyConvert(disp, x, y, width, height, s, img->Format, img->Width - width, img->Color, alpha, blend);
+        return;
+    }
+    
+    /* Draw runs of pixels between key colored pixels on visible lines */
+    mask = size == 4 ? 0x00FFFFFFUL : 0xFFFFFFFFUL; /* Alpha is not compared for ARGB8888 */
+    key = img->ColorKey & mask;
+    y1 = __GUI_MAX(y, disp->Y1);
+    y2 = __GUI_MIN(y + height, disp->Y2);
+    s += size * (uint32_t)(y1 - y) * img->Width;
+    for (i = y1; i < y2; i++, s += size * img->Width) {
+        for (k = 0, start = -1; k <= width; k++) {
+            if (k < width) {
+                switch (size) {
+                    case 4: p = *(const uint32_t *)&s[4 * k] & mask; break;
+                    case 2: p = *(const uint16_t *)&s[2 * k]; break;
+                    default: p = s[k]; break;
+                }
+            }
+            if (k < width && p != key) {
+                if (start < 0) {                    /* Run of visible pixels starts */
+                    start = k;
+                }
+            } else if (start >= 0) {                /* Run ends on key pixel or end of line */
+                __GUI_DRAW_CopyConvert(disp, x + start, i, k - start, 1, &s[size * start], img->Format, 0, img->Color, alpha, blend);
+                start = -1;
+            }
+        }
+    }
+}
+
+/* Box filter line of ARGB8888 pixels to LCD format pixels, pixels outside line are equal to edge pixels */
+/* Window sum is updated with one added and one removed pixel, cost does not depend on radius */
+static
+void __BoxBlurLine(const uint32_t* in, GUI_iDim_t len, GUI_iDim_t r, uint8_t* out) {
+    uint32_t sum[4] = {0}, mul = (0x10000UL + 2 * r) / (2 * r + 1);  /* Rounded up reciprocal keeps white at 255 */
+    uint32_t a, b;
+    GUI_Color_t c;
+    GUI_iDim_t i;
+    uint8_t k;
+    
+    for (i = -r; i <= r; i++) {                     /* Window of first pixel */
+        c = in[__GUI_MIN(__GUI_MAX(i, 0), len - 1)];
+        for (k = 0; k < 4; k++) {
+            sum[k] += (c >> (8 * k)) & 0xFF;
+        }
+    }
+    for (i = 0; i < len; i++, out += __GUI_LCD_PIXEL_SIZE()) {
+        a = in[__GUI_MIN(i + r + 1, len - 1)];      /* Pixel entering window */
+        b = in[__GUI_MAX(i - r, 0)];                /* Pixel leaving window */
+        for (c = 0, k = 0; k < 4; k++) {
+            c |= ((sum[k] * mul) >> 16) << (8 * k);
+            sum[k] += ((a >> (8 * k)) & 0xFF) - ((b >> (8 * k)) & 0xFF);
+        }
+        __Kernels()->SolidSpan(out, 1, __GUI_DRAW_ColorToLCD(c));
+    }
+}
+
+/* Get number of pixels of window with radius r around position p which are inside range */
+static
+GUI_iDim_t __WindowCoverage(GUI_iDim_t p, GUI_iDim_t start, GUI_iDim_t length, GUI_iDim_t r) {
+    return __GUI_MAX(__GUI_MIN(p + r, start + length - 1) - __GUI_MAX(p - r, start) + 1, 0);
+}
+
+void GUI_DRAW_Blur(const GUI_Display_t* disp, GUI_iDim_t x, GUI_iDim_t y, GUI_iDim_t width, GUI_iDim_t height, GUI_iDim_t r) {
+    uint32_t* in;
+    uint8_t* out[2];
+    GUI_iDim_t i, k, len;
+    uint8_t index = 0;
+    
+    r = __GUI_MIN(r, 127);                          /* Window sum of 255 pixels fits to reciprocal multiplication */
+    if (r <= 0 || !__ClipRect(disp, &x, &y, &width, &height)) {
+        return;
+    }
+    len = __GUI_MAX(width, height);
+    in = (uint32_t *)__GUI_MEMALLOC(3 * len * sizeof(*in)); /* Source line and 2 output lines */
+    if (!in) {
+        return;
+    }
+    out[0] = (uint8_t *)&in[len];                   /* Output lines are used alternately, hardware may still read previous one */
+    out[1] = (uint8_t *)&in[2 * len];
+    
+    for (i = 0; i < height; i++, index = !index) {  /* Horizontal pass */
+        __WaitPendingArea(x, y + i, x + width - 1, y + i);
+        for (k = 0; k < width; k++) {
+            in[k] = __ReadPixel(x + k, y + i);
+        }
+        __BoxBlurLine(in, width, r, out[index]);
+        __WritePixels_LCD(x, y + i, width, 1, out[index], 0);
+    }
+    for (i = 0; i < width; i++, index = !index) {   /* Vertical pass */
+        __WaitPendingArea(x + i, y, x + i, y + height - 1);
+        for (k = 0; k < height; k++) {
+            in[k] = __ReadPixel(x + i, y + k);
+        }
+        __BoxBlurLine(in, height, r, out[index]);
+        __WritePixels_LCD(x + i, y, 1, height, out[index], 0);
+    }
+    __GUI_DRAW_WaitPending();                       /* Hardware may still read output line */
+    __GUI_MEMFREE(in);
+}
+
+void GUI_DRAW_Shadow(const GUI_Display_t* disp, GUI_iDim_t x, GUI_iDim_t y, GUI_iDim_t width, GUI_iDim_t height, GUI_iDim_t r, GUI_Color_t color) {
+    GUI_iDim_t n, xm1, xm2, py, lines, cy, cs, ce, i, j, rows;
+    uint32_t a = color >> 24;
+    uint8_t side, *mask;
+    
+    r = __GUI_MIN(r, 127);                          /* Ramp of both sides must fit to mask buffer */
+    n = 2 * r + 1;
+    if (r < 0 || width <= 0 || height <= 0 || !a || __IsClipEmpty(disp) || !__GUI_RECT_MATCH(
+        disp->X1, disp->Y1, disp->X2 - 1, disp->Y2 - 1,
+        x - r, y - r, x + width + r - 1, y + height + r - 1
+    )) {
+        return;
+    }
+    xm1 = x + r;                                    /* Columns with complete horizontal coverage */
+    xm2 = x + width - r;
+    if (xm1 >= xm2) {                               /* Narrow shadow is single ramp */
+        xm1 = xm2 = x + width + r;
+    }
+    
+    for (py = __GUI_MAX(y - r, disp->Y1); py < __GUI_MIN(y + height + r, disp->Y2); py += lines) {
+        cy = __WindowCoverage(py, y, height, r);
+        lines = cy == n ? y + height - r - py : 1;  /* Lines with complete vertical coverage are equal */
+        if (xm1 < xm2) {                            /* Middle part has constant alpha */
+            __FillBlend(disp, xm1, py, xm2 - xm1, lines, (color & 0x00FFFFFFUL) | (a * cy / n) << 24);
+        }
+        for (side = 0; side < 2; side++) {          /* Left and right ramp as A8 masks */
+            cs = side ? xm2 : x - r;
+            ce = side ? x + width + r : xm1;
+            if (cs >= ce) {
+                continue;
+            }
+            for (i = 0; i < lines; i += rows) {     /* Equal lines are repeated to fill mask buffer */
+                rows = __GUI_MIN(lines - i, __MASK_SIZE / (ce - cs));
+                mask = Masks[MaskIndex];            /* Use buffers alternately, hardware may still read previous one */
+                for (j = cs; j < ce; j++) {
+                    mask[j - cs] = a * __WindowCoverage(j, x, width, r) * cy / (n * n);
+                }
+                for (j = 1; j < rows; j++) {
+                    memcpy(&mask[j * (ce - cs)], mask, ce - cs);
+                }
+                if (__GUI_DRAW_CopyConvert(disp, cs, py + i, ce - cs, rows, mask, GUI_PixelFormat_A8, 0, color, 0xFF, 1)) {
+                    MaskIndex = !MaskIndex;
+                }
+            }
+        }
+    }
+}
+
+void GUI_DRAW_Dim(const GUI_Display_t* disp, GUI_iDim_t x, GUI_iDim_t y, GUI_iDim_t width, GUI_iDim_t height, GUI_Byte level) {
+    __FillBlend(disp, x, y, width, height, (GUI_Color_t)level << 24);  /* Black color with alpha as dim level */
+}
+
 void GUI_DRAW_WriteText(const GUI_Display_t* disp, const GUI_FONT_t* font, const GUI_Char* str, GUI_DRAW_FONT_t* draw) {
     GUI_iDim_t w, h, x, y;
     uint32_t ch;
@@ -696,6 +2774,9 @@ void GUI_DRAW_WriteText(const GUI_Display_t* disp, const GUI_FONT_t* font, const
     if (!draw->LineHeight) {                        /* When line height is not set */
         draw->LineHeight = font->Size;              /* Set font size */
     }
+    if (__IsClipEmpty(disp)) {                      /* Text is not visible */
+        return;
+    }
     
     __StringRectangle(font, str, draw, &w, &h, 0);  /* Get string width for this box */
     if (w > draw->Width) {                          /* If string is wider than available rectangle */
@@ -757,6 +2838,25 @@ void GUI_DRAW_WriteText(const GUI_Display_t* disp, const GUI_FONT_t* font, const
     }
 }
 
+GUI_iDim_t GUI_DRAW_GetTextWidth(const GUI_FONT_t* font, const GUI_Char* str, GUI_DRAW_FONT_t* draw) {
+    GUI_iDim_t w;
+    
+    if (!draw->LineHeight) {                        /* When line height is not set */
+        draw->LineHeight = font->Size;              /* Set font size */
+    }
+    __StringRectangle(font, str, draw, &w, NULL, 0);    /* Get string width */
+    return w;
+}
+
+void GUI_DRAW_GetGlyphCacheStats(uint32_t* hits, uint32_t* misses) {
+    if (hits) {
+        *hits = GlyphCacheHits;
+    }
+    if (misses) {
+        *misses = GlyphCacheMisses;
+    }
+}
+
 void GUI_DRAW_ScrollBar_init(GUI_DRAW_SB_t* sb) {
     memset(sb, 0x00, sizeof(*sb));                  /* Reset structure */
 }
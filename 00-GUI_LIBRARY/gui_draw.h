@@ -187,6 +187,35 @@ typedef enum GUI_DRAW_3D_State_t {
     GUI_DRAW_3D_State_Lowered = 0x01        /*!< Lowered 3D style */
 } GUI_DRAW_3D_State_t;
 
+/**
+ * \brief           Fill rules for filled polygon
+ * \sa              GUI_DRAW_FilledPoly
+ */
+typedef enum GUI_DRAW_FillRule_t {
+    GUI_DRAW_FillRule_EvenOdd = 0x00,       /*!< Point is inside when ray from it crosses odd number of edges */
+    GUI_DRAW_FillRule_NonZero = 0x01        /*!< Point is inside when edges around it have non-zero winding number */
+} GUI_DRAW_FillRule_t;
+
+/**
+ * \brief           Line end styles for thick lines
+ * \sa              GUI_DRAW_ThickLine
+ */
+typedef enum GUI_DRAW_LineCap_t {
+    GUI_DRAW_LineCap_Butt = 0x00,           /*!< Line ends on pixels of first and last point */
+    GUI_DRAW_LineCap_Square = 0x01          /*!< Line is extended by half of width over end points */
+} GUI_DRAW_LineCap_t;
+
+/**
+ * \brief           Gradient type for gradient fills
+ */
+typedef enum GUI_DRAW_Gradient_t {
+    GUI_DRAW_Gradient_TopBottom = 0x00,     /*!< Start color on top line, stop color on bottom line */
+    GUI_DRAW_Gradient_BottomTop = 0x01,     /*!< Start color on bottom line, stop color on top line */
+    GUI_DRAW_Gradient_LeftRight = 0x02,     /*!< Start color on left column, stop color on right column */
+    GUI_DRAW_Gradient_RightLeft = 0x03,     /*!< Start color on right column, stop color on left column */
+    GUI_DRAW_Gradient_Radial = 0x04         /*!< Start color in center, stop color in corners */
+} GUI_DRAW_Gradient_t;
+
 /**
  * \brief           Poly line object coordinates
  * \sa              GUI_DRAW_Poly
@@ -203,6 +232,28 @@ typedef struct GUI_DRAW_Poly_t {
  */
 void GUI_DRAW_FONT_Init(GUI_DRAW_FONT_t* f);
 
+/**
+ * \brief           Save clipping region and intersect it with rectangle
+ * \note            Regions are saved on stack with \ref GUI_CLIP_STACK_SIZE entries, each call must be followed by \ref GUI_DRAW_PopClip
+ * \param[in,out]   *disp: Pointer to \ref GUI_Display_t structure for display operations
+ * \param[in]       x: Left position of rectangle
+ * \param[in]       y: Top position of rectangle
+ * \param[in]       width: Rectangle width
+ * \param[in]       height: Rectangle height
+ * \retval          1: New clipping region is not empty
+ * \retval          0: Nothing is visible and drawing may be skipped
+ * \sa              GUI_DRAW_PopClip
+ */
+uint8_t GUI_DRAW_PushClip(GUI_Display_t* disp, GUI_iDim_t x, GUI_iDim_t y, GUI_iDim_t width, GUI_iDim_t height);
+
+/**
+ * \brief           Restore clipping region saved with last \ref GUI_DRAW_PushClip call
+ * \param[in,out]   *disp: Pointer to \ref GUI_Display_t structure for display operations
+ * \retval          None
+ * \sa              GUI_DRAW_PushClip
+ */
+void GUI_DRAW_PopClip(GUI_Display_t* disp);
+
 /**
  * \brief           Fill screen with color
  * \param[in,out]   *disp: Pointer to \ref GUI_Display_t structure for display operations
@@ -234,6 +285,7 @@ GUI_Color_t GUI_DRAW_GetPixel(const GUI_Display_t* disp, GUI_iDim_t x, GUI_iDim_
 
 /**
  * \brief           Draw vertical line to LCD
+ * \note            Color with alpha below \ref GUI_COLOR_ALPHA_100 is blended over background
  * \param[in,out]   *disp: Pointer to \ref GUI_Display_t structure for display operations
  * \param[in]       x: Line top X position
  * \param[in]       y: Line top Y position
@@ -247,6 +299,7 @@ void GUI_DRAW_VLine(const GUI_Display_t* disp, GUI_iDim_t x, GUI_iDim_t y, GUI_i
 
 /**
  * \brief           Draw horizontal line to LCD
+ * \note            Color with alpha below \ref GUI_COLOR_ALPHA_100 is blended over background
  * \param[in,out]   *disp: Pointer to \ref GUI_Display_t structure for display operations
  * \param[in]       x: Line left X position
  * \param[in]       y: Line left Y position
@@ -272,6 +325,32 @@ void GUI_DRAW_HLine(const GUI_Display_t* disp, GUI_iDim_t x, GUI_iDim_t y, GUI_i
  */
 void GUI_DRAW_Line(const GUI_Display_t* disp, GUI_iDim_t x1, GUI_iDim_t y1, GUI_iDim_t x2, GUI_iDim_t y2, GUI_Color_t color);
 
+/**
+ * \brief           Draw anti-aliased line from point 1 to point 2
+ * \param[in,out]   *disp: Pointer to \ref GUI_Display_t structure for display operations
+ * \param[in]       x1: Line start X position
+ * \param[in]       y1: Line start Y position
+ * \param[in]       x2: Line end X position
+ * \param[in]       y2: Line end Y position
+ * \param[in]       color: Color used for drawing operation
+ * \retval          None
+ * \sa              GUI_DRAW_Line
+ * \sa              GUI_DRAW_PolyLineAA
+ */
+void GUI_DRAW_LineAA(const GUI_Display_t* disp, GUI_iDim_t x1, GUI_iDim_t y1, GUI_iDim_t x2, GUI_iDim_t y2, GUI_Color_t color);
+
+/**
+ * \brief           Draw anti-aliased lines through all points
+ * \note            Points shared by two lines are drawn once
+ * \param[in,out]   *disp: Pointer to \ref GUI_Display_t structure for display operations
+ * \param[in]       *points: Pointer to array of points
+ * \param[in]       count: Number of points in array
+ * \param[in]       color: Color used for drawing operation
+ * \retval          None
+ * \sa              GUI_DRAW_LineAA
+ */
+void GUI_DRAW_PolyLineAA(const GUI_Display_t* disp, const GUI_DRAW_Poly_t* points, uint32_t count, GUI_Color_t color);
+
 /**
  * \brief           Draw rectangle
  * \param[in,out]   *disp: Pointer to \ref GUI_Display_t structure for display operations
@@ -289,6 +368,7 @@ void GUI_DRAW_Rectangle(const GUI_Display_t* disp, GUI_iDim_t x, GUI_iDim_t y, G
 
 /**
  * \brief           Draw filled rectangle
+ * \note            Color with alpha below \ref GUI_COLOR_ALPHA_100 is blended over background
  * \param[in,out]   *disp: Pointer to \ref GUI_Display_t structure for display operations
  * \param[in]       x: Top left X position
  * \param[in]       y: Top left Y position
@@ -334,6 +414,53 @@ void GUI_DRAW_RoundedRectangle(const GUI_Display_t* disp, GUI_iDim_t x, GUI_iDim
  */
 void GUI_DRAW_FilledRoundedRectangle(const GUI_Display_t* disp, GUI_iDim_t x, GUI_iDim_t y, GUI_iDim_t width, GUI_iDim_t height, GUI_iDim_t r, GUI_Color_t color);
 
+/**
+ * \brief           Draw filled rectangle with anti-aliased rounded corners
+ * \param[in,out]   *disp: Pointer to \ref GUI_Display_t structure for display operations
+ * \param[in]       x: Top left X position
+ * \param[in]       y: Top left Y position
+ * \param[in]       width: Rectangle width
+ * \param[in]       height: Rectangle height
+ * \param[in]       r: Corner radius, max value can be r = MIN(width, height) / 2
+ * \param[in]       color: Color used for drawing operation
+ * \retval          None
+ * \sa              GUI_DRAW_FilledRoundedRectangle
+ */
+void GUI_DRAW_FilledRoundedRectangleAA(const GUI_Display_t* disp, GUI_iDim_t x, GUI_iDim_t y, GUI_iDim_t width, GUI_iDim_t height, GUI_iDim_t r, GUI_Color_t color);
+
+/**
+ * \brief           Draw rectangle filled with gradient
+ * \note            Gradient colors are drawn opaque
+ * \param[in,out]   *disp: Pointer to \ref GUI_Display_t structure for display operations
+ * \param[in]       x: Top left X position
+ * \param[in]       y: Top left Y position
+ * \param[in]       width: Rectangle width
+ * \param[in]       height: Rectangle height
+ * \param[in]       *gradient: Pointer to \ref GUI_Gradient_t structure with start and stop colors
+ * \param[in]       type: Gradient type. This parameter can be a value of \ref GUI_DRAW_Gradient_t enumeration
+ * \param[in]       dither: Set to 1 to apply ordered dither on RGB565 display, ignored for other pixel formats
+ * \retval          None
+ * \sa              GUI_DRAW_GradientRoundedRectangle
+ */
+void GUI_DRAW_GradientRectangle(const GUI_Display_t* disp, GUI_iDim_t x, GUI_iDim_t y, GUI_iDim_t width, GUI_iDim_t height, const GUI_Gradient_t* gradient, GUI_DRAW_Gradient_t type, uint8_t dither);
+
+/**
+ * \brief           Draw rectangle with rounded corners filled with gradient
+ * \note            Gradient colors are drawn opaque
+ * \param[in,out]   *disp: Pointer to \ref GUI_Display_t structure for display operations
+ * \param[in]       x: Top left X position
+ * \param[in]       y: Top left Y position
+ * \param[in]       width: Rectangle width
+ * \param[in]       height: Rectangle height
+ * \param[in]       r: Corner radius, max value can be r = MIN(width, height) / 2
+ * \param[in]       *gradient: Pointer to \ref GUI_Gradient_t structure with start and stop colors
+ * \param[in]       type: Gradient type. This parameter can be a value of \ref GUI_DRAW_Gradient_t enumeration
+ * \param[in]       dither: Set to 1 to apply ordered dither on RGB565 display, ignored for other pixel formats
+ * \retval          None
+ * \sa              GUI_DRAW_GradientRectangle
+ */
+void GUI_DRAW_GradientRoundedRectangle(const GUI_Display_t* disp, GUI_iDim_t x, GUI_iDim_t y, GUI_iDim_t width, GUI_iDim_t height, GUI_iDim_t r, const GUI_Gradient_t* gradient, GUI_DRAW_Gradient_t type, uint8_t dither);
+
 /**
  * \brief           Draw circle
  * \param[in,out]   *disp: Pointer to \ref GUI_Display_t structure for display operations
@@ -362,6 +489,18 @@ void GUI_DRAW_Circle(const GUI_Display_t* disp, GUI_iDim_t x0, GUI_iDim_t y0, GU
  */
 void GUI_DRAW_FilledCircle(const GUI_Display_t* disp, GUI_iDim_t x0, GUI_iDim_t y0, GUI_iDim_t r, GUI_Color_t color);
 
+/**
+ * \brief           Draw filled circle with anti-aliased edge
+ * \param[in,out]   *disp: Pointer to \ref GUI_Display_t structure for display operations
+ * \param[in]       x0: X position of circle center
+ * \param[in]       y0: Y position of circle center
+ * \param[in]       r: Circle radius
+ * \param[in]       color: Color used for drawing operation
+ * \retval          None
+ * \sa              GUI_DRAW_FilledCircle
+ */
+void GUI_DRAW_FilledCircleAA(const GUI_Display_t* disp, GUI_iDim_t x0, GUI_iDim_t y0, GUI_iDim_t r, GUI_Color_t color);
+
 /**
  * \brief           Draw circle corner, selected with parameter
  * \param[in,out]   *disp: Pointer to \ref GUI_Display_t structure for display operations
@@ -400,6 +539,57 @@ void GUI_DRAW_CircleCorner(const GUI_Display_t* disp, GUI_iDim_t x0, GUI_iDim_t
  */
 void GUI_DRAW_FilledCircleCorner(const GUI_Display_t* disp, GUI_iDim_t x0, GUI_iDim_t y0, GUI_iDim_t r, GUI_Byte_t c, uint32_t color);
 
+/**
+ * \brief           Draw circle arc from start to end angle
+ * \note            Angles are in degrees, 0 is on the right and angles increase clockwise.
+ *                    Arc is drawn from start angle to end angle, whole circle is drawn when difference is 360 or more
+ * \param[in,out]   *disp: Pointer to \ref GUI_Display_t structure for display operations
+ * \param[in]       x0: X position of circle center
+ * \param[in]       y0: Y position of circle center
+ * \param[in]       r: Circle radius
+ * \param[in]       start: Start angle
+ * \param[in]       end: End angle, it is greater than start angle
+ * \param[in]       color: Color used for drawing operation
+ * \retval          None
+ * \sa              GUI_DRAW_FilledPie
+ * \sa              GUI_DRAW_Ring
+ */
+void GUI_DRAW_Arc(const GUI_Display_t* disp, GUI_iDim_t x0, GUI_iDim_t y0, GUI_iDim_t r, int16_t start, int16_t end, GUI_Color_t color);
+
+/**
+ * \brief           Draw filled circle sector from start to end angle
+ * \note            Angles are the same as for \ref GUI_DRAW_Arc
+ * \param[in,out]   *disp: Pointer to \ref GUI_Display_t structure for display operations
+ * \param[in]       x0: X position of circle center
+ * \param[in]       y0: Y position of circle center
+ * \param[in]       r: Circle radius
+ * \param[in]       start: Start angle
+ * \param[in]       end: End angle, it is greater than start angle
+ * \param[in]       color: Color used for drawing operation
+ * \retval          None
+ * \sa              GUI_DRAW_Arc
+ * \sa              GUI_DRAW_Ring
+ */
+void GUI_DRAW_FilledPie(const GUI_Display_t* disp, GUI_iDim_t x0, GUI_iDim_t y0, GUI_iDim_t r, int16_t start, int16_t end, GUI_Color_t color);
+
+/**
+ * \brief           Draw thick ring part from start to end angle
+ * \note            Angles are the same as for \ref GUI_DRAW_Arc. Parts with adjacent angles do not overlap,
+ *                    so progress indicator is updated by drawing changed part only
+ * \param[in,out]   *disp: Pointer to \ref GUI_Display_t structure for display operations
+ * \param[in]       x0: X position of ring center
+ * \param[in]       y0: Y position of ring center
+ * \param[in]       r: Outer ring radius
+ * \param[in]       width: Ring width towards center
+ * \param[in]       start: Start angle
+ * \param[in]       end: End angle, it is greater than start angle
+ * \param[in]       color: Color used for drawing operation
+ * \retval          None
+ * \sa              GUI_DRAW_Arc
+ * \sa              GUI_DRAW_FilledPie
+ */
+void GUI_DRAW_Ring(const GUI_Display_t* disp, GUI_iDim_t x0, GUI_iDim_t y0, GUI_iDim_t r, GUI_iDim_t width, int16_t start, int16_t end, GUI_Color_t color);
+
 /**
  * \brief           Draw triangle
  * \param[in,out]   *disp: Pointer to \ref GUI_Display_t structure for display operations
@@ -417,6 +607,7 @@ void GUI_DRAW_Triangle(const GUI_Display_t* disp, GUI_iDim_t x1, GUI_iDim_t y1,
 
 /**
  * \brief           Draw filled triangle
+ * \note            Pixels closer than half pixel to triangle are filled, including outline drawn with \ref GUI_DRAW_Triangle
  * \param[in,out]   *disp: Pointer to \ref GUI_Display_t structure for display operations
  * \param[in]       x1: Triangle point 1 X position
  * \param[in]       y1: Triangle point 1 Y position
@@ -430,6 +621,182 @@ void GUI_DRAW_Triangle(const GUI_Display_t* disp, GUI_iDim_t x1, GUI_iDim_t y1,
  */
 void GUI_DRAW_FilledTriangle(const GUI_Display_t* disp, GUI_iDim_t x1, GUI_iDim_t y1, GUI_iDim_t x2, GUI_iDim_t y2, GUI_iDim_t x3, GUI_iDim_t y3, GUI_Color_t color);
 
+/**
+ * \brief           Draw polygon outline
+ * \note            Last point is connected with first one
+ * \param[in,out]   *disp: Pointer to \ref GUI_Display_t structure for display operations
+ * \param[in]       *points: Pointer to array of points
+ * \param[in]       len: Number of points in array
+ * \param[in]       color: Color used for drawing operation
+ * \retval          None
+ * \sa              GUI_DRAW_FilledPoly
+ */
+void GUI_DRAW_Poly(const GUI_Display_t* disp, const GUI_DRAW_Poly_t* points, GUI_Byte len, GUI_Color_t color);
+
+/**
+ * \brief           Draw filled polygon
+ * \note            Polygon may be concave or self intersecting, last point is connected with first one.
+ *                  Pixel is filled when its center is inside polygon
+ * \param[in,out]   *disp: Pointer to \ref GUI_Display_t structure for display operations
+ * \param[in]       *points: Pointer to array of points
+ * \param[in]       count: Number of points in array
+ * \param[in]       rule: Fill rule for overlapping parts of polygon. This parameter can be a value of \ref GUI_DRAW_FillRule_t enumeration
+ * \param[in]       color: Color used for drawing operation
+ * \retval          None
+ * \sa              GUI_DRAW_Poly
+ */
+void GUI_DRAW_FilledPoly(const GUI_Display_t* disp, const GUI_DRAW_Poly_t* points, uint32_t count, GUI_DRAW_FillRule_t rule, GUI_Color_t color);
+
+/**
+ * \brief           Draw line with width from point 1 to point 2
+ * \note            Line is filled as polygon with spans, drawing time depends on visible area only.
+ *                    Line with width 1 is drawn the same as with \ref GUI_DRAW_Line
+ * \param[in,out]   *disp: Pointer to \ref GUI_Display_t structure for display operations
+ * \param[in]       x1: Line start X position
+ * \param[in]       y1: Line start Y position
+ * \param[in]       x2: Line end X position
+ * \param[in]       y2: Line end Y position
+ * \param[in]       width: Line width in units of pixels
+ * \param[in]       cap: Style of line ends. This parameter can be a value of \ref GUI_DRAW_LineCap_t enumeration
+ * \param[in]       color: Color used for drawing operation
+ * \retval          None
+ * \sa              GUI_DRAW_ThickPolyLine
+ */
+void GUI_DRAW_ThickLine(const GUI_Display_t* disp, GUI_iDim_t x1, GUI_iDim_t y1, GUI_iDim_t x2, GUI_iDim_t y2, GUI_iDim_t width, GUI_DRAW_LineCap_t cap, GUI_Color_t color);
+
+/**
+ * \brief           Draw lines with width through all points
+ * \note            Lines are connected with bevel joins, cap is used on first and last point only.
+ *                    Joins are drawn once when color is not opaque, except sharp joins with lines shorter than width
+ * \param[in,out]   *disp: Pointer to \ref GUI_Display_t structure for display operations
+ * \param[in]       *points: Pointer to array of points
+ * \param[in]       count: Number of points in array
+ * \param[in]       width: Line width in units of pixels
+ * \param[in]       cap: Style of line ends. This parameter can be a value of \ref GUI_DRAW_LineCap_t enumeration
+ * \param[in]       color: Color used for drawing operation
+ * \retval          None
+ * \sa              GUI_DRAW_ThickLine
+ * \sa              GUI_DRAW_ThickPoly
+ */
+void GUI_DRAW_ThickPolyLine(const GUI_Display_t* disp, const GUI_DRAW_Poly_t* points, uint32_t count, GUI_iDim_t width, GUI_DRAW_LineCap_t cap, GUI_Color_t color);
+
+/**
+ * \brief           Draw polygon outline with width
+ * \note            Last point is connected with first one, all points are connected with bevel joins
+ * \param[in,out]   *disp: Pointer to \ref GUI_Display_t structure for display operations
+ * \param[in]       *points: Pointer to array of points
+ * \param[in]       count: Number of points in array
+ * \param[in]       width: Line width in units of pixels
+ * \param[in]       color: Color used for drawing operation
+ * \retval          None
+ * \sa              GUI_DRAW_Poly
+ * \sa              GUI_DRAW_ThickPolyLine
+ */
+void GUI_DRAW_ThickPoly(const GUI_Display_t* disp, const GUI_DRAW_Poly_t* points, uint32_t count, GUI_iDim_t width, GUI_Color_t color);
+
+/**
+ * \brief           Draw rectangle with border width
+ * \note            Border is drawn inside rectangle without overlapping parts
+ * \param[in,out]   *disp: Pointer to \ref GUI_Display_t structure for display operations
+ * \param[in]       x: Top left X position
+ * \param[in]       y: Top left Y position
+ * \param[in]       width: Rectangle width
+ * \param[in]       height: Rectangle height
+ * \param[in]       stroke: Border width in units of pixels
+ * \param[in]       color: Color used for drawing operation
+ * \retval          None
+ * \sa              GUI_DRAW_Rectangle
+ */
+void GUI_DRAW_ThickRectangle(const GUI_Display_t* disp, GUI_iDim_t x, GUI_iDim_t y, GUI_iDim_t width, GUI_iDim_t height, GUI_iDim_t stroke, GUI_Color_t color);
+
+/**
+ * \brief           Draw circle with border width
+ * \note            Border is drawn towards center, the same as \ref GUI_DRAW_Ring over full circle
+ * \param[in,out]   *disp: Pointer to \ref GUI_Display_t structure for display operations
+ * \param[in]       x0: X position of circle center
+ * \param[in]       y0: Y position of circle center
+ * \param[in]       r: Outer circle radius
+ * \param[in]       width: Border width in units of pixels
+ * \param[in]       color: Color used for drawing operation
+ * \retval          None
+ * \sa              GUI_DRAW_Circle
+ * \sa              GUI_DRAW_Ring
+ */
+void GUI_DRAW_ThickCircle(const GUI_Display_t* disp, GUI_iDim_t x0, GUI_iDim_t y0, GUI_iDim_t r, GUI_iDim_t width, GUI_Color_t color);
+
+/**
+ * \brief           Draw image
+ * \param[in,out]   *disp: Pointer to \ref GUI_Display_t structure for display operations
+ * \param[in]       x: Top left X position of image
+ * \param[in]       y: Top left Y position of image
+ * \param[in]       *img: Pointer to \ref GUI_IMAGE_DESC_t structure with image
+ * \param[in]       alpha: Image opacity, 0xFF for opaque image
+ * \retval          None
+ * \sa              GUI_DRAW_ImagePart
+ */
+void GUI_DRAW_Image(const GUI_Display_t* disp, GUI_iDim_t x, GUI_iDim_t y, const GUI_IMAGE_DESC_t* img, GUI_Byte alpha);
+
+/**
+ * \brief           Draw rectangular part of image
+ * \note            Image in display pixel format without blending and color key is copied with single low-level operation
+ * \note            Image with \ref GUI_FLAG_IMAGE_RLE flag is decoded on the fly, runs are drawn as lines or copies.
+ *                  Decoding starts at closest line from \ref GUI_IMAGE_DESC_t.LineIndex when it is set
+ * \param[in,out]   *disp: Pointer to \ref GUI_Display_t structure for display operations
+ * \param[in]       x: Top left X position where part is drawn
+ * \param[in]       y: Top left Y position where part is drawn
+ * \param[in]       *img: Pointer to \ref GUI_IMAGE_DESC_t structure with image
+ * \param[in]       xOffset: Left position of part in image
+ * \param[in]       yOffset: Top position of part in image
+ * \param[in]       width: Width of part
+ * \param[in]       height: Height of part
+ * \param[in]       alpha: Image opacity, 0xFF for opaque image
+ * \retval          None
+ * \sa              GUI_DRAW_Image
+ */
+void GUI_DRAW_ImagePart(const GUI_Display_t* disp, GUI_iDim_t x, GUI_iDim_t y, const GUI_IMAGE_DESC_t* img, GUI_iDim_t xOffset, GUI_iDim_t yOffset, GUI_iDim_t width, GUI_iDim_t height, GUI_Byte alpha);
+
+/**
+ * \brief           Blur rectangle of drawing layer in place with separable box filter
+ * \note            Time per pixel does not depend on radius. Call it multiple times for smoother result
+ * \note            Temporary buffer for 3 lines of larger rectangle dimension is allocated
+ * \param[in,out]   *disp: Pointer to \ref GUI_Display_t structure for display operations
+ * \param[in]       x: Left position of rectangle
+ * \param[in]       y: Top position of rectangle
+ * \param[in]       width: Rectangle width
+ * \param[in]       height: Rectangle height
+ * \param[in]       r: Filter radius, maximal value is 127
+ * \retval          None
+ */
+void GUI_DRAW_Blur(const GUI_Display_t* disp, GUI_iDim_t x, GUI_iDim_t y, GUI_iDim_t width, GUI_iDim_t height, GUI_iDim_t r);
+
+/**
+ * \brief           Draw soft shadow of rectangle, blended over background
+ * \note            Shadow is exact box filtered rectangle. It extends for r pixels outside rectangle,
+ *                    rectangle is usually moved down and right from window which is drawn after shadow
+ * \param[in,out]   *disp: Pointer to \ref GUI_Display_t structure for display operations
+ * \param[in]       x: Left position of rectangle casting shadow
+ * \param[in]       y: Top position of rectangle casting shadow
+ * \param[in]       width: Rectangle width
+ * \param[in]       height: Rectangle height
+ * \param[in]       r: Shadow blur radius, maximal value is 127
+ * \param[in]       color: Shadow color, alpha is used as opacity inside shadow
+ * \retval          None
+ */
+void GUI_DRAW_Shadow(const GUI_Display_t* disp, GUI_iDim_t x, GUI_iDim_t y, GUI_iDim_t width, GUI_iDim_t height, GUI_iDim_t r, GUI_Color_t color);
+
+/**
+ * \brief           Darken rectangle of drawing layer, used behind modal windows
+ * \note            Rectangle is blended with low-level \ref GUI_LL_t.BlendRect function when supported
+ * \param[in,out]   *disp: Pointer to \ref GUI_Display_t structure for display operations
+ * \param[in]       x: Left position of rectangle
+ * \param[in]       y: Top position of rectangle
+ * \param[in]       width: Rectangle width
+ * \param[in]       height: Rectangle height
+ * \param[in]       level: Dim level, 0 keeps background and 0xFF makes it black
+ * \retval          None
+ */
+void GUI_DRAW_Dim(const GUI_Display_t* disp, GUI_iDim_t x, GUI_iDim_t y, GUI_iDim_t width, GUI_iDim_t height, GUI_Byte level);
+
 /**
  * \brief           Write text to screen
  * \param[in,out]   *disp: Pointer to \ref GUI_Display_t structure for display operations
@@ -440,6 +807,25 @@ void GUI_DRAW_FilledTriangle(const GUI_Display_t* disp, GUI_iDim_t x1, GUI_iDim_
  */
 void GUI_DRAW_WriteText(const GUI_Display_t* disp, const GUI_FONT_t* font, const GUI_Char* str, GUI_DRAW_FONT_t* draw);
 
+/**
+ * \brief           Get width of text in units of pixels without drawing it
+ * \param[in]       *font: Pointer to \ref GUI_FONT_t with font to use
+ * \param[in]       *str: Pointer to string to measure
+ * \param[in]       *draw: Pointer to \ref GUI_DRAW_FONT_t with specifications about drawing style
+ * \retval          Text width in units of pixels
+ * \sa              GUI_DRAW_WriteText
+ */
+GUI_iDim_t GUI_DRAW_GetTextWidth(const GUI_FONT_t* font, const GUI_Char* str, GUI_DRAW_FONT_t* draw);
+
+/**
+ * \brief           Get statistics of anti-aliased character cache
+ * \note            Counters are 0 when cache is disabled with \ref GUI_GLYPH_CACHE_COUNT
+ * \param[out]      *hits: Pointer to output number of characters drawn from cache. Can be NULL
+ * \param[out]      *misses: Pointer to output number of characters expanded to cache. Can be NULL
+ * \retval          None
+ */
+void GUI_DRAW_GetGlyphCacheStats(uint32_t* hits, uint32_t* misses);
+
 /**
  * \brief           Draw rectangle with 3D view
  * \param[in,out]   *disp: Pointer to \ref GUI_Display_t structure for display operations
@@ -462,6 +848,25 @@ void GUI_DRAW_ScrollBar_init(GUI_DRAW_SB_t* sb);
  */
 void GUI_DRAW_ScrollBar(const GUI_Display_t* disp, GUI_DRAW_SB_t* sb);
 
+#if defined(GUI_INTERNAL) && !defined(DOXYGEN)
+//Tracking of asynchronous hardware operations
+void __GUI_DRAW_SetPending(GUI_Byte layer, GUI_iDim_t x, GUI_iDim_t y, GUI_iDim_t width, GUI_iDim_t height);
+void __GUI_DRAW_WaitPending(void);
+
+//Color conversion between GUI and LCD pixel format
+GUI_Color_t __GUI_DRAW_ColorToLCD(GUI_Color_t color);
+GUI_Color_t __GUI_DRAW_ColorFromLCD(GUI_Color_t color);
+
+//Prepare color conversion after palette was changed
+void __GUI_DRAW_SetPalette(void);
+
+//Copy source data of any pixel format to drawing layer, returns 1 when hardware may still read source after return
+uint8_t __GUI_DRAW_CopyConvert(const GUI_Display_t* disp, GUI_iDim_t x, GUI_iDim_t y, GUI_iDim_t width, GUI_iDim_t height, const void* src, GUI_PixelFormat_t format, GUI_Dim_t offLine, GUI_Color_t color, GUI_Byte alpha, uint8_t blend);
+
+//Blend same area of other layer or color with global alpha over layer, returns 1 when not supported
+uint8_t __GUI_DRAW_BlendLayer(GUI_Byte layer, GUI_iDim_t x, GUI_iDim_t y, GUI_iDim_t width, GUI_iDim_t height, const void* src, GUI_Color_t color, GUI_Byte alpha);
+#endif /* defined(GUI_INTERNAL) && !defined(DOXYGEN) */
+
 /**
  * \} GUI_DRAW
  */
@@ -27,6 +27,7 @@
 #include "gui_ll.h"
 
 #include "tm_stm32_sdram.h"
+#include "string.h"
 
 /******************************************************************************/
 /******************************************************************************/
@@ -44,6 +45,27 @@
 #define LCD_HEIGHT              272
 #define LCD_PIXEL_SIZE          4
 
+/* Pixel format for LTDC and DMA2D, both use the same register values */
+#if LCD_PIXEL_SIZE == 1
+#define LCD_PIXEL_FORMAT        LTDC_PIXEL_FORMAT_L8
+#define GUI_PIXEL_FORMAT        GUI_PixelFormat_L8
+#elif LCD_PIXEL_SIZE == 2
+#define LCD_PIXEL_FORMAT        LTDC_PIXEL_FORMAT_RGB565
+#define GUI_PIXEL_FORMAT        GUI_PixelFormat_RGB565
+#else
+#define LCD_PIXEL_FORMAT        LTDC_PIXEL_FORMAT_ARGB8888
+#define GUI_PIXEL_FORMAT        GUI_PixelFormat_ARGB8888
+#endif
+
+/* Type of single pixel in frame buffer */
+#if LCD_PIXEL_SIZE == 1
+#define LCD_PIXEL_TYPE          uint8_t
+#elif LCD_PIXEL_SIZE == 2
+#define LCD_PIXEL_TYPE          uint16_t
+#else
+#define LCD_PIXEL_TYPE          uint32_t
+#endif
+
 /* LCD configuration */
 #define LCD_HSYNC               41
 #define LCD_HBP                 13
@@ -61,6 +83,12 @@
 
 /* Number of layers */
 #define GUI_LAYERS              4
+
+/* Display rotation, panel is mapped by low-level driver */
+#define LCD_ROTATION            GUI_LCD_Rotation_0
+
+/* Check if memory address is inside layers frame buffers */
+#define LCD_IS_LAYER_ADDR(addr) ((uint32_t)(addr) >= LCD_FRAME_BUFFER && (uint32_t)(addr) < LCD_FRAME_BUFFER + GUI_LAYERS * LCD_FRAME_BUFFER_SIZE)
     
 /******************************************************************************/
 /******************************************************************************/
@@ -70,6 +98,8 @@
 static LTDC_HandleTypeDef LTDCHandle;
 static DMA2D_HandleTypeDef DMA2DHandle;
 static GUI_Layer_t Layers[GUI_LAYERS];
+static uint32_t Clut[256];                      /* Palette with opaque colors for DMA2D foreground CLUT */
+static const GUI_Color_t* ClutPalette;          /* Palette loaded to DMA2D CLUT, NULL when CLUT must be loaded again */
 
 /******************************************************************************/
 /******************************************************************************/
@@ -163,11 +193,7 @@ void _LCD_InitLCD(void) {
     layer_cfg.WindowX1 = LCD_WIDTH;
     layer_cfg.WindowY0 = 0;
     layer_cfg.WindowY1 = LCD_HEIGHT; 
-#if LCD_PIXEL_SIZE == 2
-    layer_cfg.PixelFormat = LTDC_PIXEL_FORMAT_RGB565;
-#else
-    layer_cfg.PixelFormat = LTDC_PIXEL_FORMAT_ARGB8888;
-#endif
+    layer_cfg.PixelFormat = LCD_PIXEL_FORMAT;
     layer_cfg.Alpha0 = 0;
     layer_cfg.Backcolor.Blue = 0;
     layer_cfg.Backcolor.Green = 0;
@@ -194,36 +220,259 @@ void _LCD_InitLCD(void) {
 
     HAL_LTDC_SetAlpha(&LTDCHandle, 255, 0);
     HAL_LTDC_SetAlpha(&LTDCHandle, 0, 1);
+    
+    /* Layer 2 is used for overlay plane only, disable it to save memory bandwidth */
+    __HAL_LTDC_LAYER_DISABLE(&LTDCHandle, 1);
+    __HAL_LTDC_RELOAD_CONFIG(&LTDCHandle);
+}
+
+/* Map rectangle from GUI coordinates to panel coordinates */
+static
+void _LCD_RotateRect(GUI_LCD_t* LCD, GUI_iDim_t* x, GUI_iDim_t* y, GUI_iDim_t* width, GUI_iDim_t* height) {
+    GUI_iDim_t tmp;
+    
+    switch (LCD->Rotation) {
+        case GUI_LCD_Rotation_90:               /* GUI X goes down, GUI Y goes left */
+            tmp = *x;
+            *x = LCD_WIDTH - *y - *height;
+            *y = tmp;
+            tmp = *width;
+            *width = *height;
+            *height = tmp;
+            break;
+        case GUI_LCD_Rotation_180:              /* GUI X goes left, GUI Y goes up */
+            *x = LCD_WIDTH - *x - *width;
+            *y = LCD_HEIGHT - *y - *height;
+            break;
+        case GUI_LCD_Rotation_270:              /* GUI X goes up, GUI Y goes right */
+            tmp = *y;
+            *y = LCD_HEIGHT - *x - *width;
+            *x = tmp;
+            tmp = *width;
+            *width = *height;
+            *height = tmp;
+            break;
+        default:
+            break;
+    }
+}
+
+/* Get panel address of GUI pixel in layer memory and address steps in units of pixels for next GUI column and line */
+static
+uint32_t _LCD_PanelAddr(GUI_LCD_t* LCD, const void* addr, int32_t* xStep, int32_t* yStep) {
+    uint32_t start, pos;
+    GUI_iDim_t x, y, w = 1, h = 1;
+    
+    start = LCD_FRAME_BUFFER + ((uint32_t)addr - LCD_FRAME_BUFFER) / LCD_FRAME_BUFFER_SIZE * LCD_FRAME_BUFFER_SIZE;
+    pos = ((uint32_t)addr - start) / LCD_PIXEL_SIZE;    /* Get pixel position in GUI coordinates */
+    x = pos % LCD->Width;
+    y = pos / LCD->Width;
+    _LCD_RotateRect(LCD, &x, &y, &w, &h);       /* Get pixel on panel */
+    
+    switch (LCD->Rotation) {
+        case GUI_LCD_Rotation_90:               /* GUI X goes down, GUI Y goes left */
+            *xStep = LCD_WIDTH;
+            *yStep = -1;
+            break;
+        case GUI_LCD_Rotation_180:              /* GUI X goes left, GUI Y goes up */
+            *xStep = -1;
+            *yStep = -LCD_WIDTH;
+            break;
+        case GUI_LCD_Rotation_270:              /* GUI X goes up, GUI Y goes right */
+            *xStep = -LCD_WIDTH;
+            *yStep = 1;
+            break;
+        default:
+            *xStep = 1;
+            *yStep = LCD_WIDTH;
+            break;
+    }
+    return start + LCD_PIXEL_SIZE * (LCD_WIDTH * y + x);
+}
+
+/* Map rectangle in layer memory from GUI to panel, memory outside layers is used as is */
+static
+void* _LCD_RotateAddr(GUI_LCD_t* LCD, void* addr, GUI_Dim_t xSize, GUI_Dim_t ySize, GUI_Dim_t* offLine) {
+    uint32_t start, pos;
+    GUI_iDim_t x, y, w = xSize, h = ySize;
+    
+    if (!LCD_IS_LAYER_ADDR(addr)) {             /* User memory and its offset are already in panel orientation */
+        return addr;
+    }
+    start = LCD_FRAME_BUFFER + ((uint32_t)addr - LCD_FRAME_BUFFER) / LCD_FRAME_BUFFER_SIZE * LCD_FRAME_BUFFER_SIZE;
+    pos = ((uint32_t)addr - start) / LCD_PIXEL_SIZE;    /* Get pixel position in GUI coordinates */
+    x = pos % LCD->Width;
+    y = pos / LCD->Width;
+    
+    _LCD_RotateRect(LCD, &x, &y, &w, &h);       /* Get rectangle on panel */
+    *offLine = LCD_WIDTH - w;
+    return (void *)(start + LCD_PIXEL_SIZE * (LCD_WIDTH * y + x));
+}
+
+/* Fill memory with DMA2D in panel coordinates */
+static
+void _LCD_Fill(void* dst, GUI_Dim_t xSize, GUI_Dim_t ySize, GUI_Dim_t offLine, GUI_Color_t color) {
+    uint32_t format = LCD_PIXEL_FORMAT;
+    
+    while (DMA2D->CR & DMA2D_CR_START);             /* Wait previous operation to finish */
+    
+#if LCD_PIXEL_SIZE == 1
+    /* DMA2D has no L8 output, fill 2 pixels at a time with 16-bit format when possible */
+    if (((uint32_t)dst & 0x01) || (xSize & 0x01) || (offLine & 0x01)) {
+        uint8_t* ptr = (uint8_t *)dst;
+        while (ySize--) {                           /* Fill unaligned area with CPU line by line */
+            memset(ptr, (uint8_t)color, xSize);
+            ptr += xSize + offLine;
+        }
+        return;
+    }
+    color = (color & 0xFF) | (color & 0xFF) << 8;   /* Duplicate index for pixel pair */
+    xSize >>= 1;
+    offLine >>= 1;
+    format = LTDC_PIXEL_FORMAT_RGB565;
+#endif /* LCD_PIXEL_SIZE == 1 */
+    
+    DMA2D->CR = 0x00030000UL;                       /* Register to memory and TCIE */
+    DMA2D->OCOLR = color;                           /* Color to be used */
+    DMA2D->OMAR = (uint32_t)dst;                    /* Destination address */
+    DMA2D->OOR = offLine;                           /* Destination line offset */
+    DMA2D->OPFCCR = format;                         /* Defines the number of pixels to be transfered */
+    DMA2D->NLR = (uint32_t)(xSize << 16) | (uint16_t)ySize; /* Size configuration of area to be transfered */
+    DMA2D->CR |= DMA2D_CR_START;                    /* Start actual transfer, do not wait for finish */
+}
+
+/* Fill rectangle in GUI coordinates, mapped to panel once per call */
+static
+void _LCD_FillRect(GUI_LCD_t* LCD, uint8_t layer, GUI_iDim_t x, GUI_iDim_t y, GUI_iDim_t xSize, GUI_iDim_t ySize, GUI_Color_t color) {
+    _LCD_RotateRect(LCD, &x, &y, &xSize, &ySize);
+    _LCD_Fill((void *)(Layers[layer].StartAddress + LCD_PIXEL_SIZE * (LCD_WIDTH * y + x)), xSize, ySize, LCD_WIDTH - xSize, color);
+}
+
+#if LCD_PIXEL_SIZE == 1
+/* Load GUI palette to CLUT of both LTDC layers, default is RGB332 palette */
+static
+void _LCD_SetPalette(GUI_LCD_t* LCD) {
+    static uint32_t clut[256];
+    uint32_t* colors = (uint32_t *)LCD->Palette;
+    uint16_t i, count = LCD->PaletteSize;
+    
+    if (!colors || !count) {
+        for (i = 0; i < 256; i++) {             /* Build RGB332 palette */
+            clut[i] = ((i & 0xE0) * 0xFF / 0xE0) << 16 | ((i & 0x1C) * 0xFF / 0x1C) << 8 | ((i & 0x03) * 0xFF / 0x03);
+        }
+        colors = clut;
+        count = 256;
+    } else if (count > 256) {
+        count = 256;
+    }
+    HAL_LTDC_ConfigCLUT(&LTDCHandle, colors, count, 0);
+    HAL_LTDC_ConfigCLUT(&LTDCHandle, colors, count, 1);
+    HAL_LTDC_EnableCLUT(&LTDCHandle, 0);
+    HAL_LTDC_EnableCLUT(&LTDCHandle, 1);
+}
+#endif /* LCD_PIXEL_SIZE == 1 */
+
+/* Show overlay plane with second LTDC layer, window is limited to visible part of plane */
+uint8_t _LCD_SetOverlay(GUI_LCD_t* LCD, GUI_OVERLAY_t* o) {
+    LTDC_Layer_TypeDef* l = LTDC_LAYER(&LTDCHandle, 1);
+    uint32_t ahbp, avbp;
+    GUI_iDim_t x1, y1, x2, y2;
+    
+    if (o->Flags & GUI_FLAG_OVERLAY_SOLID) {    /* Solid planes are composed by GUI */
+        return 1;
+    }
+    
+    x1 = o->X < 0 ? 0 : o->X;                   /* Get visible part of plane */
+    y1 = o->Y < 0 ? 0 : o->Y;
+    x2 = o->X + o->Width > LCD->Width ? LCD->Width : o->X + o->Width;
+    y2 = o->Y + o->Height > LCD->Height ? LCD->Height : o->Y + o->Height;
+    
+    if (!(o->Flags & GUI_FLAG_OVERLAY_VISIBLE) || !o->Alpha || x1 >= x2 || y1 >= y2) {
+        l->CR &= ~LTDC_LxCR_LEN;                /* Disable layer */
+    } else {
+        x2 -= x1;                               /* Get visible width and height */
+        y2 -= y1;
+        _LCD_RotateRect(LCD, &x1, &y1, &x2, &y2);   /* Get window on panel */
+        x2 += x1;
+        y2 += y1;
+        
+        ahbp = (LTDC->BPCR & LTDC_BPCR_AHBP) >> 16;
+        avbp = LTDC->BPCR & LTDC_BPCR_AVBP;
+        
+        l->WHPCR = ((x2 + ahbp) << 16) | (x1 + ahbp + 1);   /* Set window position */
+        l->WVPCR = ((y2 + avbp) << 16) | (y1 + avbp + 1);
+        l->CFBAR = LCD->Layers[LCD->OverlayLayer].StartAddress + LCD_PIXEL_SIZE * (LCD_WIDTH * y1 + x1);
+        l->CFBLR = ((LCD_WIDTH * LCD_PIXEL_SIZE) << 16) | ((x2 - x1) * LCD_PIXEL_SIZE + 3); /* Pitch is full line of layer */
+        l->CFBLNR = y2 - y1;                    /* Set number of lines */
+        l->CACR = o->Alpha;                     /* Set constant alpha */
+        l->CR |= LTDC_LxCR_LEN;                 /* Enable layer */
+    }
+    LTDC->SRCR = LTDC_SRCR_VBR;                 /* Reload on vertical blanking */
+    return 0;
 }
 
 void LCD_Init(GUI_LCD_t* LCD) {
     TM_SDRAM_Init();                /* Init SDRAM */
 
     _LCD_InitLCD();                 /* Init LCD */
+#if LCD_PIXEL_SIZE == 1
+    _LCD_SetPalette(LCD);           /* Load default palette */
+#endif /* LCD_PIXEL_SIZE == 1 */
 }
 
 void LCD_SetPixel(GUI_LCD_t* LCD, uint8_t layer, GUI_Dim_t x, GUI_Dim_t y, GUI_Color_t color) {
-    uint32_t addr = LCD_FRAME_BUFFER + (layer * LCD_FRAME_BUFFER_SIZE) + LCD_PIXEL_SIZE * (LCD_WIDTH * y + x);
+    GUI_iDim_t px = x, py = y, w = 1, h = 1;
+    uint32_t addr;
+    
+    _LCD_RotateRect(LCD, &px, &py, &w, &h);         /* Get pixel on panel */
+    addr = Layers[layer].StartAddress + LCD_PIXEL_SIZE * (LCD_WIDTH * py + px);
+#if LCD_PIXEL_SIZE == 1
+    *(volatile uint8_t *)(addr) = (uint8_t)color;
+#elif LCD_PIXEL_SIZE == 2
+    *(volatile uint16_t *)(addr) = (uint16_t)color;
+#else
     *(volatile uint32_t *)(addr) = color;
+#endif
 }
 
 GUI_Color_t LCD_GetPixel(GUI_LCD_t* LCD, uint8_t layer, GUI_Dim_t x, GUI_Dim_t y) {
-    return *(volatile GUI_Color_t *)(LCD_FRAME_BUFFER + (layer * LCD_FRAME_BUFFER_SIZE) + LCD_PIXEL_SIZE * (LCD_WIDTH * y + x));
+    GUI_iDim_t px = x, py = y, w = 1, h = 1;
+    
+    _LCD_RotateRect(LCD, &px, &py, &w, &h);         /* Get pixel on panel */
+#if LCD_PIXEL_SIZE == 1
+    return *(volatile uint8_t *)(Layers[layer].StartAddress + LCD_PIXEL_SIZE * (LCD_WIDTH * py + px));
+#elif LCD_PIXEL_SIZE == 2
+    return *(volatile uint16_t *)(Layers[layer].StartAddress + LCD_PIXEL_SIZE * (LCD_WIDTH * py + px));
+#else
+    return *(volatile GUI_Color_t *)(Layers[layer].StartAddress + LCD_PIXEL_SIZE * (LCD_WIDTH * py + px));
+#endif
 }
 
 void LCD_Fill(GUI_LCD_t* LCD, uint8_t layer, void* dst, GUI_Dim_t xSize, GUI_Dim_t ySize, GUI_Dim_t OffLine, GUI_Color_t color) {
-    DMA2D->CR = 0x00030000UL;                       /* Register to memory and TCIE */
-    DMA2D->OCOLR = color;                           /* Color to be used */
-    DMA2D->OMAR = (uint32_t)dst;                    /* Destination address */
-    DMA2D->OOR = OffLine;                           /* Destination line offset */
-    DMA2D->OPFCCR = LTDC_PIXEL_FORMAT_ARGB8888;     /* Defines the number of pixels to be transfered */
-    DMA2D->NLR = (uint32_t)(xSize << 16) | (uint16_t)ySize; /* Size configuration of area to be transfered */
-    DMA2D->CR |= DMA2D_CR_START;                    /* Start actual transfer */
-    
-    while (DMA2D->CR & DMA2D_CR_START);             /* Wait previous operation to finish */
+    if (LCD->Rotation != GUI_LCD_Rotation_0) {      /* Map area to panel */
+        dst = _LCD_RotateAddr(LCD, dst, xSize, ySize, &OffLine);
+        if (LCD->Rotation != GUI_LCD_Rotation_180) {
+            GUI_Dim_t tmp = xSize;
+            xSize = ySize;
+            ySize = tmp;
+        }
+    }
+    _LCD_Fill(dst, xSize, ySize, OffLine, color);
 }
 
 void LCD_Copy(GUI_LCD_t* LCD, uint8_t layer, void* src, void* dst, GUI_Dim_t xSize, GUI_Dim_t ySize, GUI_Dim_t offLineSrc, GUI_Dim_t offLineDst) {
+    if (LCD->Rotation != GUI_LCD_Rotation_0) {      /* Map both areas to panel, DMA2D copies rectangle as is */
+        src = _LCD_RotateAddr(LCD, src, xSize, ySize, &offLineSrc);
+        dst = _LCD_RotateAddr(LCD, dst, xSize, ySize, &offLineDst);
+        if (LCD->Rotation != GUI_LCD_Rotation_180) {
+            GUI_Dim_t tmp = xSize;
+            xSize = ySize;
+            ySize = tmp;
+        }
+    }
+    
+    while (DMA2D->CR & DMA2D_CR_START);             /* Wait previous operation to finish */
+    
     DMA2D->CR = 0x00000000;             /* Memory to memory transfer mode */
 
     /* Set up pointers */
@@ -233,33 +482,180 @@ void LCD_Copy(GUI_LCD_t* LCD, uint8_t layer, void* src, void* dst, GUI_Dim_t xSi
     DMA2D->OOR = offLineDst; 
 
     /* Set up pixel format */  
-    DMA2D->FGPFCCR = LTDC_PIXEL_FORMAT_ARGB8888;
+    DMA2D->FGPFCCR = LCD_PIXEL_FORMAT;
 
     /* Set up size */
     DMA2D->NLR = (uint32_t)(xSize << 16) | (uint16_t)ySize; 
 
-    /* Start DMA2D */
+    /* Start DMA2D, do not wait for finish */
     DMA2D->CR |= DMA2D_CR_START; 
+}
 
-    while (DMA2D->CR & DMA2D_CR_START);
+void LCD_WritePixels(GUI_LCD_t* LCD, uint8_t layer, GUI_Dim_t x, GUI_Dim_t y, GUI_Dim_t xSize, GUI_Dim_t ySize, const void* pixels, GUI_Dim_t offLine) {
+    const uint8_t* p = (const uint8_t *)pixels;
+    uint32_t addr = Layers[layer].StartAddress + LCD_PIXEL_SIZE * (LCD->Width * y + x), d;
+    int32_t xStep, yStep;
+    GUI_iDim_t i, k;
+    
+    if (LCD->Rotation == GUI_LCD_Rotation_0) {      /* Copy pixels to layer memory with DMA2D */
+        LCD_Copy(LCD, layer, (void *)pixels, (void *)addr, xSize, ySize, offLine, LCD_WIDTH - xSize);
+        return;
+    }
+    
+    addr = _LCD_PanelAddr(LCD, (void *)addr, &xStep, &yStep);  /* Map rectangle to panel once */
+    xStep *= LCD_PIXEL_SIZE;
+    yStep *= LCD_PIXEL_SIZE;
+    
+    while (DMA2D->CR & DMA2D_CR_START);             /* Wait previous operation to finish */
+    for (i = 0; i < ySize; i++, p += LCD_PIXEL_SIZE * offLine, addr += yStep) {  /* Source is not rotated, write with panel steps */
+        for (k = 0, d = addr; k < xSize; k++, p += LCD_PIXEL_SIZE, d += xStep) {
+            *(LCD_PIXEL_TYPE *)d = *(const LCD_PIXEL_TYPE *)p;
+        }
+    }
 }
 
-void LCD_DrawHLine(GUI_LCD_t* LCD, uint8_t layer, GUI_Dim_t x, GUI_Dim_t y, GUI_Dim_t length, GUI_Color_t color) {
-    uint32_t addr = LCD_FRAME_BUFFER + (layer * LCD_FRAME_BUFFER_SIZE) + (LCD_PIXEL_SIZE * (LCD->Width * y + x));
+/* Start DMA2D conversion or blending of foreground to output in panel coordinates */
+static
+void _LCD_Convert(const void* src, uint32_t dst, uint32_t pfc, GUI_Dim_t xSize, GUI_Dim_t ySize, GUI_Dim_t offLineSrc, GUI_Dim_t offLineDst, GUI_Color_t color, uint8_t blend) {
+    while (DMA2D->CR & DMA2D_CR_START);             /* Wait previous operation to finish */
+    
+    DMA2D->CR = blend ? 0x00020000UL : 0x00010000UL;/* Memory to memory with blending or pixel format conversion */
+    
+    /* Set up foreground */
+    DMA2D->FGMAR = (uint32_t)src;
+    DMA2D->FGOR = offLineSrc;
+    DMA2D->FGPFCCR = pfc;
+    DMA2D->FGCOLR = color & 0x00FFFFFFUL;           /* Color for A8 source */
     
-    LCD_Fill(LCD, layer, (void *)addr, length, 1, LCD->Width - length, color);
+    /* Set up background, destination is blended with foreground */
+    if (blend) {
+        DMA2D->BGMAR = dst;
+        DMA2D->BGOR = offLineDst;
+        DMA2D->BGPFCCR = LCD_PIXEL_FORMAT;
+    }
+    
+    /* Set up output */
+    DMA2D->OMAR = dst;
+    DMA2D->OOR = offLineDst;
+    DMA2D->OPFCCR = LCD_PIXEL_FORMAT;
+    
+    DMA2D->NLR = (uint32_t)(xSize << 16) | (uint16_t)ySize;
+    DMA2D->CR |= DMA2D_CR_START;                    /* Start DMA2D, do not wait for finish */
 }
 
-void LCD_DrawVLine(GUI_LCD_t* LCD, uint8_t layer, GUI_Dim_t x, GUI_Dim_t y, GUI_Dim_t length, GUI_Color_t color) {
-    uint32_t addr = Layers[layer].StartAddress + (LCD_PIXEL_SIZE * (LCD->Width * y + x));
+uint8_t LCD_CopyConvert(GUI_LCD_t* LCD, uint8_t layer, const void* src, void* dst, GUI_PixelFormat_t format, GUI_Dim_t xSize, GUI_Dim_t ySize, GUI_Dim_t offLineSrc, GUI_Dim_t offLineDst, GUI_Color_t color, GUI_Byte alpha, uint8_t blend) {
+    const uint8_t* s = (const uint8_t *)src;
+    uint32_t pfc, size, addr;
+    int32_t xStep, yStep;
+    GUI_iDim_t i;
+    
+    /* DMA2D cannot output L8 and cannot write pixels of one line in reverse order */
+    if (LCD_PIXEL_SIZE == 1 || LCD->Rotation == GUI_LCD_Rotation_180) {
+        return 1;
+    }
+    switch (format) {                               /* Get foreground color mode */
+        case GUI_PixelFormat_ARGB8888:
+            pfc = CM_ARGB8888;
+            size = 4;
+            break;
+        case GUI_PixelFormat_RGB565:
+            pfc = CM_RGB565;
+            size = 2;
+            break;
+        case GUI_PixelFormat_A8:
+            pfc = CM_A8;
+            size = 1;
+            break;
+        case GUI_PixelFormat_L8:
+            if (!LCD->Palette) {                    /* Default palette is not stored in memory */
+                return 1;
+            }
+            pfc = CM_L8 | ((uint32_t)(LCD->PaletteSize - 1) << 8);  /* ARGB8888 CLUT with palette size */
+            size = 1;
+            break;
+        default:
+            return 1;
+    }
+    pfc |= (uint32_t)alpha << 24 | DMA2D_COMBINE_ALPHA << 16;   /* Multiply pixel alpha with global alpha */
     
-    LCD_Fill(LCD, layer, (void *)addr, 1, length, LCD->Width - 1, color);
+    if (format == GUI_PixelFormat_L8 && ClutPalette != LCD->Palette) {  /* Load palette to foreground CLUT when changed */
+        for (i = 0; i < LCD->PaletteSize; i++) {    /* Palette has no alpha, CLUT is in ARGB8888 format */
+            Clut[i] = LCD->Palette[i] | 0xFF000000UL;
+        }
+        while (DMA2D->CR & DMA2D_CR_START);         /* Wait previous operation to finish */
+        DMA2D->FGCMAR = (uint32_t)Clut;
+        DMA2D->FGPFCCR = pfc | DMA2D_FGPFCCR_START;
+        while (DMA2D->FGPFCCR & DMA2D_FGPFCCR_START);
+        ClutPalette = LCD->Palette;
+    }
+    
+    if (LCD->Rotation == GUI_LCD_Rotation_0) {
+        _LCD_Convert(src, (uint32_t)dst, pfc, xSize, ySize, offLineSrc, offLineDst, color, blend);
+        return 0;
+    }
+    
+    /* Rectangle is mapped to panel once, then every GUI line or column which is in panel order is transferred as single pixel wide area */
+    addr = _LCD_PanelAddr(LCD, dst, &xStep, &yStep);
+    if (LCD->Rotation == GUI_LCD_Rotation_90) {     /* GUI line is panel column going down */
+        for (i = 0; i < ySize; i++, s += size * (xSize + offLineSrc), addr += LCD_PIXEL_SIZE * yStep) {
+            _LCD_Convert(s, addr, pfc, 1, xSize, 0, LCD_WIDTH - 1, color, blend);
+        }
+    } else {                                        /* GUI column is panel line going right */
+        for (i = 0; i < xSize; i++, s += size, addr += LCD_PIXEL_SIZE * xStep) {
+            _LCD_Convert(s, addr, pfc, 1, ySize, xSize + offLineSrc - 1, 0, color, blend);
+        }
+    }
+    return 0;
 }
 
-void LCD_FillRect(GUI_LCD_t* LCD, uint8_t layer, GUI_Dim_t x, GUI_Dim_t y, GUI_Dim_t xSize, GUI_Dim_t ySize, GUI_Color_t color) {
-    uint32_t addr = Layers[layer].StartAddress + (LCD_PIXEL_SIZE * (LCD->Width * y + x));
+uint8_t LCD_BlendRect(GUI_LCD_t* LCD, uint8_t layer, GUI_Dim_t x, GUI_Dim_t y, GUI_Dim_t xSize, GUI_Dim_t ySize, GUI_Color_t color) {
+    GUI_iDim_t px = x, py = y, w = xSize, h = ySize;
+    uint32_t dst, offLine;
+    
+    if (LCD_PIXEL_SIZE == 1) {                      /* DMA2D cannot output L8 */
+        return 1;
+    }
+    _LCD_RotateRect(LCD, &px, &py, &w, &h);         /* Fixed color has no orientation, only area is mapped to panel */
+    dst = Layers[layer].StartAddress + LCD_PIXEL_SIZE * (LCD_WIDTH * py + px);
+    offLine = LCD_WIDTH - w;
+    
+    while (DMA2D->CR & DMA2D_CR_START);             /* Wait previous operation to finish */
+    
+    DMA2D->CR = 0x00020000UL;                       /* Memory to memory with blending */
+    
+    /* Set up foreground, A8 data is read from destination but replaced with fixed alpha and color */
+    DMA2D->FGMAR = dst;
+    DMA2D->FGOR = offLine;
+    DMA2D->FGPFCCR = CM_A8 | (color & 0xFF000000UL) | DMA2D_REPLACE_ALPHA << 16;
+    DMA2D->FGCOLR = color & 0x00FFFFFFUL;
+    
+    /* Set up background and output, both are destination area */
+    DMA2D->BGMAR = dst;
+    DMA2D->BGOR = offLine;
+    DMA2D->BGPFCCR = LCD_PIXEL_FORMAT;
+    DMA2D->OMAR = dst;
+    DMA2D->OOR = offLine;
+    DMA2D->OPFCCR = LCD_PIXEL_FORMAT;
     
-    LCD_Fill(LCD, layer, (void *)addr, xSize, ySize, LCD->Width - xSize, color);
+    DMA2D->NLR = (uint32_t)(w << 16) | (uint16_t)h;
+    DMA2D->CR |= DMA2D_CR_START;                    /* Start DMA2D, do not wait for finish */
+    return 0;
+}
+
+uint8_t LCD_IsBusy(GUI_LCD_t* LCD) {
+    return (DMA2D->CR & DMA2D_CR_START) ? 1 : 0;    /* DMA2D is busy until start bit is cleared by hardware */
+}
+
+void LCD_DrawHLine(GUI_LCD_t* LCD, uint8_t layer, GUI_Dim_t x, GUI_Dim_t y, GUI_Dim_t length, GUI_Color_t color) {
+    _LCD_FillRect(LCD, layer, x, y, length, 1, color); /* Vertical line on panel when rotated by 90 or 270 degrees */
+}
+
+void LCD_DrawVLine(GUI_LCD_t* LCD, uint8_t layer, GUI_Dim_t x, GUI_Dim_t y, GUI_Dim_t length, GUI_Color_t color) {
+    _LCD_FillRect(LCD, layer, x, y, 1, length, color); /* Horizontal line on panel when rotated by 90 or 270 degrees */
+}
+
+void LCD_FillRect(GUI_LCD_t* LCD, uint8_t layer, GUI_Dim_t x, GUI_Dim_t y, GUI_Dim_t xSize, GUI_Dim_t ySize, GUI_Color_t color) {
+    _LCD_FillRect(LCD, layer, x, y, xSize, ySize, color);
 }
 
 /* IRQ function for LTDC */
@@ -293,8 +689,15 @@ uint8_t GUI_LL_Init(GUI_LCD_t* LCD, GUI_LL_t* LL) {
     /*******************************/
     /* Set up LCD data             */
     /*******************************/
-    LCD->Width = LCD_WIDTH;
-    LCD->Height = LCD_HEIGHT;
+    LCD->Rotation = LCD_ROTATION;
+    LCD->PixelFormat = GUI_PIXEL_FORMAT;
+    if (LCD->Rotation == GUI_LCD_Rotation_90 || LCD->Rotation == GUI_LCD_Rotation_270) {
+        LCD->Width = LCD_HEIGHT;                /* Portrait mode, GUI dimensions are swapped */
+        LCD->Height = LCD_WIDTH;
+    } else {
+        LCD->Width = LCD_WIDTH;
+        LCD->Height = LCD_HEIGHT;
+    }
     
     /*******************************/
     /* Set layers count            */
@@ -305,6 +708,10 @@ uint8_t GUI_LL_Init(GUI_LCD_t* LCD, GUI_LL_t* LL) {
         Layers[i].Num = i;
         Layers[i].StartAddress = LCD_FRAME_BUFFER + (i * LCD_FRAME_BUFFER_SIZE);
     }
+    LCD->OverlayLayer = 2;                      /* First 2 layers are used for drawing, third for overlay planes */
+    if (LCD->Rotation == GUI_LCD_Rotation_0) {
+        LCD->Flags |= GUI_FLAG_LCD_DIRECT;      /* Frame buffer matches GUI coordinates, allow direct access */
+    }
     
     /*******************************/
     /* Set up LCD drawing routines */
@@ -314,10 +721,14 @@ uint8_t GUI_LL_Init(GUI_LCD_t* LCD, GUI_LL_t* LL) {
     LL->SetPixel = &LCD_SetPixel;               /* Must be set by user */
     
     LL->Copy = &LCD_Copy;                       /* Set copy memory routine */
+    LL->CopyConvert = &LCD_CopyConvert;         /* Set copy with pixel format conversion routine */
+    LL->WritePixels = &LCD_WritePixels;         /* Set write pixels from memory routine */
     LL->DrawHLine = &LCD_DrawHLine;             /* Set drawing vertical line routine */
     LL->DrawVLine = &LCD_DrawVLine;             /* Set drawing horizontal line routine */
     LL->Fill = &LCD_Fill;                       /* Set fill screen routine */
     LL->FillRect = &LCD_FillRect;               /* Set fill rectangle routine */
+    LL->BlendRect = &LCD_BlendRect;             /* Set blend color over rectangle routine */
+    LL->IsBusy = &LCD_IsBusy;                   /* Set hardware busy check routine */
     
     return 0;                                   /* Initialization successful */
 }
@@ -329,6 +740,16 @@ uint8_t GUI_LL_Control(GUI_LCD_t* LCD, GUI_LL_Command_t cmd, void* data) {
             LCD->Layers[layer].Pending = 1;     /* Set layer as pending and redraw on next reload */
             break;
         }
+        case GUI_LL_Command_SetOverlay: {       /* Show overlay plane on hardware layer */
+            return _LCD_SetOverlay(LCD, (GUI_OVERLAY_t *)data);
+        }
+        case GUI_LL_Command_SetPalette: {       /* Load color lookup table */
+            ClutPalette = 0;                    /* Palette content may change with the same pointer */
+#if LCD_PIXEL_SIZE == 1
+            _LCD_SetPalette(LCD);
+#endif /* LCD_PIXEL_SIZE == 1 */
+            break;
+        }
         default:
             break;
     }
@@ -0,0 +1,325 @@
+/**	
+ * |----------------------------------------------------------------------
+ * | Copyright (c) 2017 Tilen Majerle
+ * |  
+ * | Permission is hereby granted, free of charge, to any person
+ * | obtaining a copy of this software and associated documentation
+ * | files (the "Software"), to deal in the Software without restriction,
+ * | including without limitation the rights to use, copy, modify, merge,
+ * | publish, distribute, sublicense, and/or sell copies of the Software, 
+ * | and to permit persons to whom the Software is furnished to do so, 
+ * | subject to the following conditions:
+ * | 
+ * | The above copyright notice and this permission notice shall be
+ * | included in all copies or substantial portions of the Software.
+ * | 
+ * | THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * | EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * | OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * | AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * | HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * | WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING 
+ * | FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * | OTHER DEALINGS IN THE SOFTWARE.
+ * |----------------------------------------------------------------------
+ */
+#define GUI_INTERNAL
+#include "gui_overlay.h"
+
+/******************************************************************************/
+/******************************************************************************/
+/***                           Private structures                            **/
+/******************************************************************************/
+/******************************************************************************/
+
+/******************************************************************************/
+/******************************************************************************/
+/***                           Private definitions                           **/
+/******************************************************************************/
+/******************************************************************************/
+#define __GO(x)             ((GUI_OVERLAY_t *)(x))
+
+/* Number of bytes per pixel depends on LCD pixel format */
+#define __PIXEL_SIZE        __GUI_LCD_PIXEL_SIZE()
+
+/* Get memory address of pixel on layer */
+#define __LayerAddress(layer, x, y)     (void *)(GUI.LCD.Layers[(layer)].StartAddress + __PIXEL_SIZE * ((uint32_t)GUI.LCD.Width * (y) + (x)))
+
+/******************************************************************************/
+/******************************************************************************/
+/***                            Private variables                            **/
+/******************************************************************************/
+/******************************************************************************/
+
+/******************************************************************************/
+/******************************************************************************/
+/***                            Private functions                            **/
+/******************************************************************************/
+/******************************************************************************/
+/* Get visible part of plane on LCD, returns 0 if plane is outside LCD */
+static
+uint8_t __GetVisibleArea(GUI_OVERLAY_t* o, GUI_Display_t* area) {
+    area->X1 = __GUI_MAX(o->X, 0);
+    area->Y1 = __GUI_MAX(o->Y, 0);
+    area->X2 = __GUI_MIN(o->X + o->Width, GUI.LCD.Width);
+    area->Y2 = __GUI_MIN(o->Y + o->Height, GUI.LCD.Height);
+    return area->X1 < area->X2 && area->Y1 < area->Y2;
+}
+
+/* Apply plane parameters to hardware or schedule software composition */
+static
+void __Update(GUI_OVERLAY_t* o) {
+    if (o->Flags & GUI_FLAG_OVERLAY_HW) {           /* Plane is on hardware layer */
+        GUI_LL_Control(&GUI.LCD, GUI_LL_Command_SetOverlay, o); /* Only register write is required */
+    } else {
+        o->Flags |= GUI_FLAG_OVERLAY_DIRTY;         /* Compose again on next process */
+    }
+}
+
+/* Blend plane pixels with global alpha on top of layer */
+/* Pixels are blended by hardware or in memory, pixel by pixel only when layer memory does not match GUI coordinates */
+static
+void __BlendArea(GUI_OVERLAY_t* o, GUI_Byte layer, const GUI_Display_t* area) {
+    GUI_iDim_t x, y;
+    GUI_Color_t fg, bg;
+    uint32_t a = o->Alpha, na = 255 - o->Alpha;
+    
+    if (!__GUI_DRAW_BlendLayer(layer, area->X1, area->Y1, area->X2 - area->X1, area->Y2 - area->Y1,
+            (o->Flags & GUI_FLAG_OVERLAY_SOLID) ? 0 : __LayerAddress(GUI.LCD.OverlayLayer, area->X1, area->Y1), o->Color, o->Alpha)) {
+        return;
+    }
+    
+    __GUI_DRAW_WaitPending();                       /* CPU access to memory used by hardware */
+    for (y = area->Y1; y < area->Y2; y++) {
+        for (x = area->X1; x < area->X2; x++) {
+            if (o->Flags & GUI_FLAG_OVERLAY_SOLID) {
+                fg = o->Color;
+            } else {
+                fg = __GUI_DRAW_ColorFromLCD(GUI.LL.GetPixel(&GUI.LCD, GUI.LCD.OverlayLayer, x, y));
+            }
+            bg = __GUI_DRAW_ColorFromLCD(GUI.LL.GetPixel(&GUI.LCD, layer, x, y));
+            GUI.LL.SetPixel(&GUI.LCD, layer, x, y, __GUI_DRAW_ColorToLCD(
+                (bg & 0xFF000000UL) |
+                ((((fg >> 16) & 0xFF) * a + ((bg >> 16) & 0xFF) * na) / 255) << 16 |
+                ((((fg >>  8) & 0xFF) * a + ((bg >>  8) & 0xFF) * na) / 255) << 8 |
+                ((((fg >>  0) & 0xFF) * a + ((bg >>  0) & 0xFF) * na) / 255)
+            ));
+        }
+    }
+}
+
+/******************************************************************************/
+/******************************************************************************/
+/***                                Public API                               **/
+/******************************************************************************/
+/******************************************************************************/
+GUI_OVERLAY_t* __GUI_OVERLAY_Create(GUI_iDim_t x, GUI_iDim_t y, GUI_Dim_t width, GUI_Dim_t height, uint8_t flags) {
+    GUI_OVERLAY_t* ptr;
+    
+    ptr = (GUI_OVERLAY_t *)__GUI_MEMALLOC(sizeof(GUI_OVERLAY_t));  /* Allocate memory for plane */
+    if (ptr) {
+        memset(ptr, 0x00, sizeof(GUI_OVERLAY_t));   /* Reset memory */
+        
+        ptr->X = x;                                 /* Set position */
+        ptr->Y = y;
+        ptr->Width = width;                         /* Set size */
+        ptr->Height = height;
+        ptr->Alpha = 0xFF;                          /* Opaque by default */
+        ptr->Flags = flags & ~(GUI_FLAG_OVERLAY_VISIBLE | GUI_FLAG_OVERLAY_HW | GUI_FLAG_OVERLAY_SHOWN);
+        
+        __GUI_LINKEDLIST_ADD_GEN(&GUI.Overlays, &ptr->List);    /* Add plane to linked list */
+    }
+    return ptr;
+}
+
+uint8_t __GUI_OVERLAY_Remove(GUI_OVERLAY_t** o) {
+    GUI_OVERLAY_t* ptr;
+    
+    __GUI_ASSERTPARAMS(o && *o);                    /* Check input parameters */
+    
+    if ((*o)->Flags & GUI_FLAG_OVERLAY_HW) {        /* Release hardware layer */
+        __GUI_OVERLAY_Hide(*o);
+    } else if ((*o)->Flags & GUI_FLAG_OVERLAY_SHOWN) {  /* Plane is composed on active layer */
+        __GUI_OVERLAY_Restore(GUI.LCD.ActiveLayer); /* Remove all software planes from active layer */
+        for (ptr = __GO(GUI.Overlays.First); ptr; ptr = __GO(ptr->List.Next)) {
+            ptr->Flags &= ~GUI_FLAG_OVERLAY_SHOWN;  /* Other planes must be composed again */
+            ptr->Flags |= GUI_FLAG_OVERLAY_DIRTY;
+        }
+    }
+    ptr = *o;
+    __GUI_LINKEDLIST_REMOVE_GEN(&GUI.Overlays, &ptr->List); /* Remove plane from linked list */
+    if (ptr->Background) {
+        __GUI_DRAW_WaitPending();                   /* Restore copy may still read background */
+        __GUI_MEMFREE(ptr->Background);             /* Free saved background memory */
+    }
+    __GUI_MEMFREE(ptr);                             /* Free memory for plane */
+    *o = 0;                                         /* Restore pointer */
+    
+    return 1;
+}
+
+uint8_t __GUI_OVERLAY_SetPosition(GUI_OVERLAY_t* o, GUI_iDim_t x, GUI_iDim_t y) {
+    __GUI_ASSERTPARAMS(o);                          /* Check input parameters */
+    if (o->X != x || o->Y != y) {                   /* Check for change */
+        o->X = x;
+        o->Y = y;
+        __Update(o);                                /* Update plane */
+    }
+    return 1;
+}
+
+uint8_t __GUI_OVERLAY_SetSize(GUI_OVERLAY_t* o, GUI_Dim_t width, GUI_Dim_t height) {
+    __GUI_ASSERTPARAMS(o);                          /* Check input parameters */
+    if (o->Width != width || o->Height != height) { /* Check for change */
+        o->Width = width;
+        o->Height = height;
+        __Update(o);                                /* Update plane */
+    }
+    return 1;
+}
+
+uint8_t __GUI_OVERLAY_SetAlpha(GUI_OVERLAY_t* o, GUI_Byte alpha) {
+    __GUI_ASSERTPARAMS(o);                          /* Check input parameters */
+    if (o->Alpha != alpha) {                        /* Check for change */
+        o->Alpha = alpha;
+        __Update(o);                                /* Update plane */
+    }
+    return 1;
+}
+
+uint8_t __GUI_OVERLAY_SetColor(GUI_OVERLAY_t* o, GUI_Color_t color) {
+    __GUI_ASSERTPARAMS(o);                          /* Check input parameters */
+    if (o->Color != color) {                        /* Check for change */
+        o->Color = color;
+        __Update(o);                                /* Update plane */
+    }
+    return 1;
+}
+
+uint8_t __GUI_OVERLAY_Show(GUI_OVERLAY_t* o) {
+    __GUI_ASSERTPARAMS(o);                          /* Check input parameters */
+    if (o->Flags & GUI_FLAG_OVERLAY_VISIBLE) {      /* Already visible */
+        return 1;
+    }
+    o->Flags |= GUI_FLAG_OVERLAY_VISIBLE;
+    
+    /* Try to get hardware layer for plane if not used by other plane */
+    if (!GUI.OverlayHW && GUI.LCD.OverlayLayer && !(o->Flags & (GUI_FLAG_OVERLAY_SOLID | GUI_FLAG_OVERLAY_SHOWN))) {
+        if (!GUI_LL_Control(&GUI.LCD, GUI_LL_Command_SetOverlay, o)) {  /* Command processed by hardware */
+            o->Flags |= GUI_FLAG_OVERLAY_HW;
+            GUI.OverlayHW = o;
+            return 1;
+        }
+    }
+    __Update(o);                                    /* Update plane */
+    return 1;
+}
+
+uint8_t __GUI_OVERLAY_Hide(GUI_OVERLAY_t* o) {
+    __GUI_ASSERTPARAMS(o);                          /* Check input parameters */
+    if (!(o->Flags & GUI_FLAG_OVERLAY_VISIBLE)) {   /* Already hidden */
+        return 1;
+    }
+    o->Flags &= ~GUI_FLAG_OVERLAY_VISIBLE;
+    __Update(o);                                    /* Update plane */
+    
+    if (o->Flags & GUI_FLAG_OVERLAY_HW) {           /* Release hardware layer for other planes */
+        o->Flags &= ~GUI_FLAG_OVERLAY_HW;
+        GUI.OverlayHW = 0;
+    }
+    return 1;
+}
+
+uint8_t __GUI_OVERLAY_Invalidate(GUI_OVERLAY_t* o) {
+    __GUI_ASSERTPARAMS(o);                          /* Check input parameters */
+    if (!(o->Flags & GUI_FLAG_OVERLAY_HW)) {        /* Hardware reads pixels directly from overlay layer */
+        o->Flags |= GUI_FLAG_OVERLAY_DIRTY;         /* Compose again on next process */
+    }
+    return 1;
+}
+
+uint8_t __GUI_OVERLAY_IsDirty(void) {
+    GUI_OVERLAY_t* o;
+    
+    for (o = __GO(GUI.Overlays.First); o; o = __GO(o->List.Next)) {
+        if (o->Flags & GUI_FLAG_OVERLAY_DIRTY) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+void __GUI_OVERLAY_Restore(GUI_Byte layer) {
+    GUI_OVERLAY_t* o;
+    GUI_Dim_t width, height;
+    
+    /* Restore in reverse order in case planes overlap */
+    for (o = __GO(GUI.Overlays.Last); o; o = __GO(o->List.Prev)) {
+        if (!(o->Flags & GUI_FLAG_OVERLAY_SHOWN)) { /* Plane is not composed */
+            continue;
+        }
+        width = o->Shown.X2 - o->Shown.X1;
+        height = o->Shown.Y2 - o->Shown.Y1;
+        GUI.LL.Copy(&GUI.LCD, layer, o->Background, __LayerAddress(layer, o->Shown.X1, o->Shown.Y1), width, height, 0, GUI.LCD.Width - width);
+        __GUI_DRAW_SetPending(layer, o->Shown.X1, o->Shown.Y1, width, height);
+    }
+}
+
+void __GUI_OVERLAY_Compose(GUI_Byte layer) {
+    GUI_OVERLAY_t* o;
+    GUI_Display_t area;
+    GUI_Dim_t width, height;
+    uint32_t size;
+    
+    for (o = __GO(GUI.Overlays.First); o; o = __GO(o->List.Next)) {
+        if (o->Flags & GUI_FLAG_OVERLAY_HW) {       /* Hardware plane is composed by LCD controller */
+            continue;
+        }
+        o->Flags &= ~(GUI_FLAG_OVERLAY_DIRTY | GUI_FLAG_OVERLAY_SHOWN);
+        if (!(o->Flags & GUI_FLAG_OVERLAY_VISIBLE) || !o->Alpha || !__GetVisibleArea(o, &area)) {
+            continue;
+        }
+        width = area.X2 - area.X1;
+        height = area.Y2 - area.Y1;
+        
+        /* Allocate memory for background */
+        size = (uint32_t)width * (uint32_t)height;
+        if (o->BackgroundSize < size) {
+            if (o->Background) {
+                __GUI_DRAW_WaitPending();           /* Restore copy may still read old background */
+                __GUI_MEMFREE(o->Background);
+            }
+            o->Background = (GUI_Color_t *)__GUI_MEMALLOC(size * __PIXEL_SIZE);
+            o->BackgroundSize = o->Background ? size : 0;
+            if (!o->Background) {
+                __GUI_DEBUG("Alloc failed for overlay background with %d bytes\r\n", (int)(size * __PIXEL_SIZE));
+                continue;
+            }
+        }
+        
+        /* Save background below plane */
+        GUI.LL.Copy(&GUI.LCD, layer, __LayerAddress(layer, area.X1, area.Y1), o->Background, width, height, GUI.LCD.Width - width, 0);
+        __GUI_DRAW_SetPending(layer, area.X1, area.Y1, width, height);
+        
+        /* Compose plane on top of layer */
+        if (o->Alpha < 0xFF) {                      /* Blend with background */
+            __BlendArea(o, layer, &area);
+        } else if (o->Flags & GUI_FLAG_OVERLAY_SOLID) {
+            GUI.LL.FillRect(&GUI.LCD, layer, area.X1, area.Y1, width, height, __GUI_DRAW_ColorToLCD(o->Color));
+            __GUI_DRAW_SetPending(layer, area.X1, area.Y1, width, height);
+        } else {
+            GUI.LL.Copy(&GUI.LCD, layer, __LayerAddress(GUI.LCD.OverlayLayer, area.X1, area.Y1), __LayerAddress(layer, area.X1, area.Y1), width, height, GUI.LCD.Width - width, GUI.LCD.Width - width);
+            __GUI_DRAW_SetPending(layer, area.X1, area.Y1, width, height);
+        }
+        memcpy(&o->Shown, &area, sizeof(area));     /* Save composed area */
+        o->Flags |= GUI_FLAG_OVERLAY_SHOWN;
+    }
+}
+
+void __GUI_OVERLAY_Process(void) {
+    if (!__GUI_OVERLAY_IsDirty()) {                 /* Nothing to update */
+        return;
+    }
+    __GUI_OVERLAY_Restore(GUI.LCD.ActiveLayer);     /* Remove planes from shown layer */
+    __GUI_OVERLAY_Compose(GUI.LCD.ActiveLayer);     /* Compose planes on new positions */
+}
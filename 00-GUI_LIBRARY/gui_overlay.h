@@ -0,0 +1,211 @@
+/**
+ * \author  Tilen Majerle <tilen@majerle.eu>
+ * \brief   GUI overlay planes
+ *	
+\verbatim
+   ----------------------------------------------------------------------
+    Copyright (c) 2017 Tilen Majerle
+
+    Permission is hereby granted, free of charge, to any person
+    obtaining a copy of this software and associated documentation
+    files (the "Software"), to deal in the Software without restriction,
+    including without limitation the rights to use, copy, modify, merge,
+    publish, distribute, sublicense, and/or sell copies of the Software, 
+    and to permit persons to whom the Software is furnished to do so, 
+    subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be
+    included in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+    OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+    AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+    HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+    WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING 
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+    OTHER DEALINGS IN THE SOFTWARE.
+   ----------------------------------------------------------------------
+\endverbatim
+ */
+#ifndef GUI_OVERLAY_H
+#define GUI_OVERLAY_H
+
+/* C++ detection */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * \addtogroup      GUI
+ * \{
+ */
+#include "gui.h"
+
+/**
+ * \defgroup        GUI_OVERLAY Overlay planes
+ * \brief           Planes composed on top of drawing layer without widget redraw
+ * \{
+ *
+ * Overlay plane is rectangular area shown on top of all widgets.
+ *
+ * When low-level driver supports hardware layer (LTDC second layer), plane pixels are read from overlay layer
+ * and show, hide, move or alpha changes are only register writes.
+ *
+ * When hardware is not available, plane is composed in software. Background below plane is saved before
+ * composition and restored on next change, so content below plane is never redrawn.
+ */
+
+#if defined(GUI_INTERNAL) || defined(DOXYGEN)
+
+#define GUI_FLAG_OVERLAY_VISIBLE        ((uint8_t)(1 << 0UL))   /*!< Plane is visible */
+#define GUI_FLAG_OVERLAY_SOLID          ((uint8_t)(1 << 1UL))   /*!< Plane is filled with solid color instead of overlay layer pixels */
+#define GUI_FLAG_OVERLAY_HW             ((uint8_t)(1 << 2UL))   /*!< Plane is shown using hardware layer */
+#define GUI_FLAG_OVERLAY_SHOWN          ((uint8_t)(1 << 3UL))   /*!< Plane is composed in software and background is saved */
+#define GUI_FLAG_OVERLAY_DIRTY          ((uint8_t)(1 << 4UL))   /*!< Software plane must be composed again */
+
+/**
+ * \brief           Create new overlay plane
+ * \note            Since this function is private, it can only be used by user inside GUI library
+ * \note            Plane is hidden after creation
+ * \param[in]       x: Top left X position on LCD
+ * \param[in]       y: Top left Y position on LCD
+ * \param[in]       width: Plane width in units of pixels
+ * \param[in]       height: Plane height in units of pixels
+ * \param[in]       flags: List of flags for plane
+ * \retval          > 0: Plane created
+ * \retval          0: Plane creation failed
+ */
+GUI_OVERLAY_t* __GUI_OVERLAY_Create(GUI_iDim_t x, GUI_iDim_t y, GUI_Dim_t width, GUI_Dim_t height, uint8_t flags);
+
+/**
+ * \brief           Remove overlay plane and restore content below it
+ * \note            Since this function is private, it can only be used by user inside GUI library
+ * \param[in]       **o: Pointer to pointer to \ref GUI_OVERLAY_t structure.
+ *                      After plane remove, pointer value where it points to will be changed
+ * \retval          1: Plane was removed ok
+ * \retval          0: Plane was not removed
+ */
+uint8_t __GUI_OVERLAY_Remove(GUI_OVERLAY_t** o);
+
+/**
+ * \brief           Set plane position on LCD
+ * \note            Since this function is private, it can only be used by user inside GUI library
+ * \param[in,out]   *o: Pointer to \ref GUI_OVERLAY_t structure
+ * \param[in]       x: Top left X position on LCD
+ * \param[in]       y: Top left Y position on LCD
+ * \retval          1: Position was set ok
+ * \retval          0: Position was not set
+ */
+uint8_t __GUI_OVERLAY_SetPosition(GUI_OVERLAY_t* o, GUI_iDim_t x, GUI_iDim_t y);
+
+/**
+ * \brief           Set plane size
+ * \note            Since this function is private, it can only be used by user inside GUI library
+ * \param[in,out]   *o: Pointer to \ref GUI_OVERLAY_t structure
+ * \param[in]       width: Plane width in units of pixels
+ * \param[in]       height: Plane height in units of pixels
+ * \retval          1: Size was set ok
+ * \retval          0: Size was not set
+ */
+uint8_t __GUI_OVERLAY_SetSize(GUI_OVERLAY_t* o, GUI_Dim_t width, GUI_Dim_t height);
+
+/**
+ * \brief           Set plane global alpha
+ * \note            Since this function is private, it can only be used by user inside GUI library
+ * \param[in,out]   *o: Pointer to \ref GUI_OVERLAY_t structure
+ * \param[in]       alpha: Alpha value, 0 = transparent, 255 = opaque
+ * \retval          1: Alpha was set ok
+ * \retval          0: Alpha was not set
+ */
+uint8_t __GUI_OVERLAY_SetAlpha(GUI_OVERLAY_t* o, GUI_Byte alpha);
+
+/**
+ * \brief           Set plane color for solid planes
+ * \note            Since this function is private, it can only be used by user inside GUI library
+ * \param[in,out]   *o: Pointer to \ref GUI_OVERLAY_t structure
+ * \param[in]       color: Plane color
+ * \retval          1: Color was set ok
+ * \retval          0: Color was not set
+ */
+uint8_t __GUI_OVERLAY_SetColor(GUI_OVERLAY_t* o, GUI_Color_t color);
+
+/**
+ * \brief           Show plane on LCD
+ * \note            Since this function is private, it can only be used by user inside GUI library
+ * \param[in,out]   *o: Pointer to \ref GUI_OVERLAY_t structure
+ * \retval          1: Plane was shown ok
+ * \retval          0: Plane was not shown
+ * \sa              __GUI_OVERLAY_Hide
+ */
+uint8_t __GUI_OVERLAY_Show(GUI_OVERLAY_t* o);
+
+/**
+ * \brief           Hide plane from LCD
+ * \note            Since this function is private, it can only be used by user inside GUI library
+ * \param[in,out]   *o: Pointer to \ref GUI_OVERLAY_t structure
+ * \retval          1: Plane was hidden ok
+ * \retval          0: Plane was not hidden
+ * \sa              __GUI_OVERLAY_Show
+ */
+uint8_t __GUI_OVERLAY_Hide(GUI_OVERLAY_t* o);
+
+/**
+ * \brief           Notify plane that pixels on overlay layer were changed
+ * \note            Since this function is private, it can only be used by user inside GUI library
+ * \param[in,out]   *o: Pointer to \ref GUI_OVERLAY_t structure
+ * \retval          1: Plane was invalidated ok
+ * \retval          0: Plane was not invalidated
+ */
+uint8_t __GUI_OVERLAY_Invalidate(GUI_OVERLAY_t* o);
+
+/**
+ * \brief           Check if any software plane must be composed again
+ * \note            Since this function is private, it can only be used by user inside GUI library
+ * \retval          1: At least one plane is waiting for composition
+ * \retval          0: No planes are waiting for composition
+ */
+uint8_t __GUI_OVERLAY_IsDirty(void);
+
+/**
+ * \brief           Restore saved background below all software planes on specific layer
+ * \note            Since this function is private, it can only be used by user inside GUI library
+ * \param[in]       layer: Layer number to restore background on
+ * \retval          None
+ * \sa              __GUI_OVERLAY_Compose
+ */
+void __GUI_OVERLAY_Restore(GUI_Byte layer);
+
+/**
+ * \brief           Save background and compose all visible software planes on specific layer
+ * \note            Since this function is private, it can only be used by user inside GUI library
+ * \param[in]       layer: Layer number to compose planes on
+ * \retval          None
+ * \sa              __GUI_OVERLAY_Restore
+ */
+void __GUI_OVERLAY_Compose(GUI_Byte layer);
+
+/**
+ * \brief           Internal processing called by GUI library
+ * \note            Since this function is private, it can only be used by user inside GUI library
+ * \note            Updates software planes directly on active layer when no redraw is in progress
+ * \retval          None
+ */
+void __GUI_OVERLAY_Process(void);
+
+#endif /* defined(GUI_INTERNAL) || defined(DOXYGEN) */
+
+/**
+ * \}
+ */
+
+/**
+ * \}
+ */
+
+/* C++ detection */
+#ifdef __cplusplus
+}
+#endif
+
+#endif
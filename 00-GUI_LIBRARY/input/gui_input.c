@@ -57,6 +57,34 @@ static GUI_Byte_t KBBufferData[GUI_TOUCH_BUFFER_SIZE * sizeof(GUI_KeyboardData_t
 /***                            Private functions                            **/
 /******************************************************************************/
 /******************************************************************************/
+#if GUI_USE_TOUCH
+/* Map touch coordinates from panel to rotated GUI coordinates */
+static
+void __RotateTouch(GUI_TouchData_t* ts) {
+    GUI_iDim_t x;
+    uint8_t i;
+    
+    for (i = 0; i < ts->Count && i < GUI_TOUCH_MAX_PRESSES; i++) {
+        x = ts->X[i];
+        switch (GUI.LCD.Rotation) {
+            case GUI_LCD_Rotation_90:               /* Panel width is GUI height */
+                ts->X[i] = ts->Y[i];
+                ts->Y[i] = GUI.LCD.Height - 1 - x;
+                break;
+            case GUI_LCD_Rotation_180:
+                ts->X[i] = GUI.LCD.Width - 1 - x;
+                ts->Y[i] = GUI.LCD.Height - 1 - ts->Y[i];
+                break;
+            case GUI_LCD_Rotation_270:              /* Panel height is GUI width */
+                ts->X[i] = GUI.LCD.Width - 1 - ts->Y[i];
+                ts->Y[i] = x;
+                break;
+            default:
+                break;
+        }
+    }
+}
+#endif /* GUI_USE_TOUCH */
 
 /******************************************************************************/
 /******************************************************************************/
@@ -65,8 +93,12 @@ static GUI_Byte_t KBBufferData[GUI_TOUCH_BUFFER_SIZE * sizeof(GUI_KeyboardData_t
 /******************************************************************************/
 #if GUI_USE_TOUCH
 uint8_t GUI_INPUT_TouchAdd(GUI_TouchData_t* ts) {
+    GUI_TouchData_t t;
+    
     ts->Time = GUI.Time;                            /* Set event time */
-    return GUI_BUFFER_Write(&TSBuffer, ts, sizeof(*ts)) ? 1 : 0;    /* Write data to buffer */
+    memcpy(&t, ts, sizeof(t));                      /* Keep user coordinates unchanged */
+    __RotateTouch(&t);                              /* Map coordinates to GUI */
+    return GUI_BUFFER_Write(&TSBuffer, &t, sizeof(t)) ? 1 : 0;  /* Write data to buffer */
 }
 
 uint8_t __GUI_INPUT_TouchRead(GUI_TouchData_t* ts) {
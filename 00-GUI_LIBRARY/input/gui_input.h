@@ -45,6 +45,7 @@ extern "C" {
 
 /**
  * \brief           Add new touch data to internal buffer for further processing
+ * \note            Coordinates are in panel orientation and are rotated to match LCD rotation
  * \param[in]       *ts: Pointer to \ref GUI_TouchData_t touch data with valid input
  * \retval          1: Success
  * \retval          0: Failure
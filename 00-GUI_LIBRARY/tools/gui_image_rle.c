@@ -0,0 +1,184 @@
+/**	
+ * |----------------------------------------------------------------------
+ * | Copyright (c) 2017 Tilen Majerle
+ * |  
+ * | Permission is hereby granted, free of charge, to any person
+ * | obtaining a copy of this software and associated documentation
+ * | files (the "Software"), to deal in the Software without restriction,
+ * | including without limitation the rights to use, copy, modify, merge,
+ * | publish, distribute, sublicense, and/or sell copies of the Software, 
+ * | and to permit persons to whom the Software is furnished to do so, 
+ * | subject to the following conditions:
+ * | 
+ * | The above copyright notice and this permission notice shall be
+ * | included in all copies or substantial portions of the Software.
+ * | 
+ * | THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * | EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * | OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * | AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * | HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * | WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING 
+ * | FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * | OTHER DEALINGS IN THE SOFTWARE.
+ * |----------------------------------------------------------------------
+ */
+
+/**
+ * Host tool converting raw RGBA image dump to run-length encoded image for GUI_DRAW_Image.
+ *
+ * Usage: gui_image_rle [-i] <input.rgba> <width> <height> <argb8888|rgb565|a8|l8> <name> [key]
+ *
+ * Input contains 4 bytes per pixel in R, G, B, A order, lines stored one after another.
+ * L8 output uses RGB332 colors, A8 output uses input alpha channel only.
+ * Optional key is raw pixel value in output format which is drawn transparent.
+ * With -i option offsets of every 16th line are written to GUI_IMAGE_DESC_t.LineIndex,
+ * so parts of image can be drawn without decoding all lines above them.
+ * Generated C source is written to standard output.
+ *
+ * Build on host with: cc -o gui_image_rle gui_image_rle.c
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+/* Output pixel formats, same order as GUI_PixelFormat_t */
+static const char* Formats[] = {"argb8888", "rgb565", "l8", "a8"};
+static const char* FormatNames[] = {"GUI_PixelFormat_ARGB8888", "GUI_PixelFormat_RGB565", "GUI_PixelFormat_L8", "GUI_PixelFormat_A8"};
+static const uint8_t Sizes[] = {4, 2, 1, 1};
+
+static uint32_t* Out;                               /* Encoded image in units of output pixels */
+static uint32_t OutCount;                           /* Number of used units */
+
+#define INDEX_LINES                 16              /* Must match GUI_IMAGE_RLE_INDEX_LINES */
+
+/* Convert RGBA input pixel to raw output pixel */
+static
+uint32_t ConvertPixel(const uint8_t* p, int format) {
+    switch (format) {
+        case 1:
+            return ((p[0] & 0xF8) << 8) | ((p[1] & 0xFC) << 3) | (p[2] >> 3);
+        case 2:
+            return (p[0] & 0xE0) | ((p[1] & 0xE0) >> 3) | (p[2] >> 6);
+        case 3:
+            return p[3];
+        default:
+            return ((uint32_t)p[3] << 24) | ((uint32_t)p[0] << 16) | ((uint32_t)p[1] << 8) | p[2];
+    }
+}
+
+/* Encode single line to runs, key pixels are always stored as repeated runs */
+static
+void EncodeLine(const uint32_t* line, uint32_t width, uint32_t top, int useKey, uint32_t key, uint32_t keyMask) {
+    uint32_t i = 0, n, max = top;                   /* Header stores length minus 1 in bits below top bit */
+    
+    while (i < width) {
+        for (n = 1; i + n < width && n < max && line[i + n] == line[i]; n++);
+        if (n >= 2 || (useKey && (line[i] & keyMask) == key)) {
+            Out[OutCount++] = top | (n - 1);        /* Repeated run */
+            Out[OutCount++] = line[i];
+            i += n;
+            continue;
+        }
+        
+        /* Collect pixels until two equal pixels or key pixel are found */
+        for (n = 1; i + n < width && n < max; n++) {
+            if ((i + n + 1 < width && line[i + n] == line[i + n + 1]) || (useKey && (line[i + n] & keyMask) == key)) {
+                break;
+            }
+        }
+        Out[OutCount++] = n - 1;                    /* Literal run */
+        memcpy(&Out[OutCount], &line[i], n * sizeof(*line));
+        OutCount += n;
+        i += n;
+    }
+}
+
+int main(int argc, char** argv) {
+    FILE* f;
+    uint8_t* in;
+    uint32_t *line, *index;
+    uint32_t width, height, x, y, top, key = 0, keyMask, indexCount;
+    int format, useKey, useIndex = argc > 1 && !strcmp(argv[1], "-i");
+    
+    if (useIndex) {                                 /* Remove option from arguments */
+        argv[1] = argv[0];
+        argv++;
+        argc--;
+    }
+    useKey = argc > 6;
+    if (argc < 6) {
+        fprintf(stderr, "Usage: %s [-i] <input.rgba> <width> <height> <argb8888|rgb565|a8|l8> <name> [key]\n", argv[0]);
+        return 1;
+    }
+    width = strtoul(argv[2], NULL, 0);
+    height = strtoul(argv[3], NULL, 0);
+    for (format = 0; format < 4 && strcmp(argv[4], Formats[format]); format++);
+    if (!width || !height || format == 4) {
+        fprintf(stderr, "Invalid size or format\n");
+        return 1;
+    }
+    if (useKey) {
+        key = strtoul(argv[6], NULL, 0);
+    }
+    top = 1UL << (8 * Sizes[format] - 1);
+    keyMask = format == 0 ? 0x00FFFFFFUL : 0xFFFFFFFFUL;   /* Alpha is not compared for ARGB8888 */
+    key &= keyMask;
+    
+    indexCount = (height + INDEX_LINES - 1) / INDEX_LINES;
+    in = malloc(4 * width * height);
+    line = malloc(width * sizeof(*line));
+    index = malloc(indexCount * sizeof(*index));
+    Out = malloc(2 * width * height * sizeof(*Out));    /* Worst case is header for each pixel */
+    if (!in || !line || !index || !Out) {
+        fprintf(stderr, "Out of memory\n");
+        return 1;
+    }
+    f = fopen(argv[1], "rb");
+    if (!f || fread(in, 4, width * height, f) != width * height) {
+        fprintf(stderr, "Cannot read %s\n", argv[1]);
+        return 1;
+    }
+    fclose(f);
+    
+    for (y = 0; y < height; y++) {
+        if (!(y % INDEX_LINES)) {                   /* Offset of indexed line */
+            index[y / INDEX_LINES] = OutCount;
+        }
+        for (x = 0; x < width; x++) {
+            line[x] = ConvertPixel(&in[4 * (y * width + x)], format);
+        }
+        EncodeLine(line, width, top, useKey, key, keyMask);
+    }
+    
+    /* Array type matches pixel size to keep runs aligned for DMA */
+    printf("#include \"gui.h\"\n\n");
+    printf("/* %s: %ux%u, %u bytes, %u bytes raw */\n", argv[5], width, height, OutCount * Sizes[format], width * height * Sizes[format]);
+    printf("static GUI_Const uint%d_t %s_Data[%u] = {", 8 * Sizes[format], argv[5], OutCount);
+    for (x = 0; x < OutCount; x++) {
+        printf("%s0x%0*X,", x % 12 ? " " : "\n    ", 2 * Sizes[format], Out[x]);
+    }
+    printf("\n};\n\n");
+    if (useIndex) {
+        printf("static GUI_Const uint32_t %s_Index[%u] = {", argv[5], indexCount);
+        for (x = 0; x < indexCount; x++) {
+            printf("%s%u,", x % 12 ? " " : "\n    ", index[x]);
+        }
+        printf("\n};\n\n");
+    }
+    printf("GUI_Const GUI_IMAGE_DESC_t %s = {\n", argv[5]);
+    printf("    %u,\n    %u,\n    %s,\n", width, height, FormatNames[format]);
+    printf("    GUI_FLAG_IMAGE_RLE%s,\n", useKey ? " | GUI_FLAG_IMAGE_COLORKEY" : "");
+    printf("    GUI_COLOR_BLACK,\n    0x%08X,\n    %s_Data", key, argv[5]);
+    if (useIndex) {
+        printf(",\n    %s_Index", argv[5]);
+    }
+    printf("\n};\n");
+    
+    free(in);
+    free(line);
+    free(index);
+    free(Out);
+    return 0;
+}
@@ -393,7 +393,6 @@ uint8_t GUI_DROPDOWN_Callback(GUI_HANDLE_p h, GUI_WC_t ctrl, void* param, void*
                 uint16_t yOffset;
                 uint16_t itemHeight;                /* Get item height */
                 uint16_t index = 0;                 /* Start index */
-                GUI_iDim_t tmp;
                 
                 itemHeight = __ItemHeight(h, &yOffset); /* Get item height and Y offset */
                 
@@ -410,10 +409,7 @@ uint8_t GUI_DROPDOWN_Callback(GUI_HANDLE_p h, GUI_WC_t ctrl, void* param, void*
                     item && index < o->VisibleStartIndex; 
                     item = (GUI_DROPDOWN_ITEM_t *)__GUI_LINKEDLIST_GETNEXT_GEN(NULL, &item->List), index++);
                 
-                tmp = disp->Y2;
-                if (disp->Y2 > (y + height)) {      /* Set cut-off Y position for drawing operations */
-                    disp->Y2 = y + height;
-                }
+                GUI_DRAW_PushClip(disp, x, y, width, height);  /* Set cut-off position for drawing operations */
                 while (height && item) {            /* Try to process all strings */                    
                     if (index == __GD(h)->Selected) {
                         GUI_DRAW_FilledRectangle(disp, x + 2, f.Y, width - 3, __GUI_MIN(f.Height, itemHeight), __GUI_WIDGET_IsFocused(h) ? __GUI_WIDGET_GetColor(h, GUI_DROPDOWN_COLOR_SEL_FOC_BG) : __GUI_WIDGET_GetColor(h, GUI_DROPDOWN_COLOR_SEL_NOFOC_BG));
@@ -429,7 +425,7 @@ uint8_t GUI_DROPDOWN_Callback(GUI_HANDLE_p h, GUI_WC_t ctrl, void* param, void*
                     item = (GUI_DROPDOWN_ITEM_t *)__GUI_LINKEDLIST_GETNEXT_GEN(NULL, &item->List);
                     index++;
                 }
-                disp->Y2 = tmp;                     /* Set temporary value back */
+                GUI_DRAW_PopClip(disp);             /* Set previous region back */
             }
             return 1;
         }
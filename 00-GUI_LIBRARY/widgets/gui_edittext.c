@@ -38,6 +38,9 @@
 /******************************************************************************/
 /******************************************************************************/
 #define __GE(x)             ((GUI_EDITTEXT_t *)(x))
+
+/* Text cursor blink period in units of milliseconds */
+#define EDITTEXT_CURSOR_PERIOD      500
     
 static
 uint8_t GUI_EDITTEXT_Callback(GUI_HANDLE_p h, GUI_WC_t ctrl, void* param, void* result);
@@ -67,10 +70,59 @@ const static GUI_WIDGET_t Widget = {
 /***                            Private functions                            **/
 /******************************************************************************/
 /******************************************************************************/
+/* Check if cursor plane is covered by widgets above edittext or above any of its parents */
+static
+uint8_t __IsCursorCovered(GUI_EDITTEXT_t* edit) {
+    GUI_HANDLE_p h, h2;
+    GUI_iDim_t x1, y1, x2, y2;
+    GUI_OVERLAY_t* c = edit->Cursor;
+    
+    for (h = __GH(edit); h; h = __GH(h)->Parent) {
+        for (h2 = __GUI_LINKEDLIST_WidgetGetNext(NULL, h); h2; h2 = __GUI_LINKEDLIST_WidgetGetNext(NULL, h2)) {
+            if (__GUI_WIDGET_IsHidden(h2)) {
+                continue;
+            }
+            __GUI_WIDGET_GetLCDAbsPosAndVisibleWidthHeight(h2, &x1, &y1, &x2, &y2);
+            if (__GUI_RECT_MATCH(x1, y1, x2 - 1, y2 - 1, c->X, c->Y, c->X + c->Width - 1, c->Y + c->Height - 1)) {
+                return 1;
+            }
+        }
+    }
+    return 0;
+}
+
+/* Show cursor plane only when no other widget is drawn over it */
+static
+void __ShowCursor(GUI_EDITTEXT_t* edit) {
+    if (edit->Cursor->Width && edit->Cursor->Height && !__IsCursorCovered(edit)) {
+        __GUI_OVERLAY_Show(edit->Cursor);
+    } else {
+        __GUI_OVERLAY_Hide(edit->Cursor);
+    }
+}
+
 void TimerCallback(GUI_TIMER_t* timer) {
     GUI_EDITTEXT_t* edit = __GE(__GUI_TIMER_GetParams(timer));  /* Get parameters from timer */
     
-    __GUI_WIDGET_Invalidate(__GH(edit));            /* Invalidate widget */
+    if (!edit->Cursor) {
+        return;
+    }
+    if (edit->Cursor->Flags & GUI_FLAG_OVERLAY_VISIBLE) {   /* Toggle cursor plane only, widget is not redrawn */
+        __GUI_OVERLAY_Hide(edit->Cursor);
+    } else {
+        __ShowCursor(edit);                         /* Covering widgets are checked on each blink */
+    }
+}
+
+/* Remove text cursor plane and stop blinking */
+static
+void __RemoveCursor(GUI_EDITTEXT_t* edit) {
+    if (edit->Cursor) {
+        __GUI_OVERLAY_Remove(&edit->Cursor);
+    }
+    if (__GH(edit)->Timer) {
+        __GUI_TIMER_Remove(&__GH(edit)->Timer);
+    }
 }
 
 #define e          ((GUI_EDITTEXT_t *)h)
@@ -107,13 +159,49 @@ uint8_t GUI_EDITTEXT_Callback(GUI_HANDLE_p h, GUI_WC_t ctrl, void* param, void*
                 f.Color1 = __GUI_WIDGET_GetColor(h, GUI_EDITTEXT_COLOR_FG);
                 f.Flags |= GUI_FLAG_FONT_RIGHTALIGN;
                 GUI_DRAW_WriteText(disp, __GH(h)->Font, __GH(h)->Text, &f);
+                
+                if (e->Cursor) {                    /* Put cursor at the end of text */
+                    GUI_iDim_t w = GUI_DRAW_GetTextWidth(__GH(h)->Font, __GH(h)->Text, &f);
+                    GUI_iDim_t x1, y1, x2, y2, cx, cy1, cy2;
+                    if (w > f.Width - 1) {
+                        w = f.Width - 1;
+                    }
+                    cx = f.X + w;
+                    cy1 = f.Y + (f.Height - f.LineHeight) / 2;
+                    cy2 = cy1 + (f.LineHeight > f.Height ? f.Height : f.LineHeight);
+                    
+                    /* Clip cursor to visible part of widget inside parents */
+                    __GUI_WIDGET_GetLCDAbsPosAndVisibleWidthHeight(h, &x1, &y1, &x2, &y2);
+                    cy1 = __GUI_MAX(cy1, y1);
+                    cy2 = __GUI_MIN(cy2, y2);
+                    __GUI_OVERLAY_SetPosition(e->Cursor, cx, cy1);
+                    __GUI_OVERLAY_SetSize(e->Cursor, cx >= x1 && cx < x2 && cy1 < cy2, cy1 < cy2 ? cy2 - cy1 : 0);
+                    __GUI_OVERLAY_SetColor(e->Cursor, f.Color1);
+                    __ShowCursor(e);                /* Show cursor after each redraw */
+                    if (__GH(h)->Timer) {
+                        __GUI_TIMER_Reset(__GH(h)->Timer);  /* Start new blink period */
+                    }
+                }
             }
             return 1;
         }
-        case GUI_WC_FocusIn:
+        case GUI_WC_FocusIn: {
+            if (!e->Cursor) {
+                e->Cursor = __GUI_OVERLAY_Create(0, 0, 0, 0, GUI_FLAG_OVERLAY_SOLID);   /* Position is set on draw */
+            }
+            if (e->Cursor && !__GH(h)->Timer) {
+                __GH(h)->Timer = __GUI_TIMER_Create(EDITTEXT_CURSOR_PERIOD, TimerCallback, h, GUI_FLAG_TIMER_PERIODIC);
+                if (__GH(h)->Timer) {
+                    __GUI_TIMER_Start(__GH(h)->Timer);  /* Start blinking */
+                }
+            }
+            __GUI_WIDGET_Invalidate(h);             /* Redraw to set cursor position */
             return 1;
-        case GUI_WC_FocusOut:
+        }
+        case GUI_WC_FocusOut: {
+            __RemoveCursor(e);                      /* Remove cursor from screen, also called when focused widget is deleted */
             return 1;
+        }
 #if GUI_USE_TOUCH
         case GUI_WC_TouchStart: {
             *(__GUI_TouchStatus_t *)result = touchHANDLED;
@@ -63,6 +63,7 @@ typedef enum GUI_EDITTEXT_COLOR_t {
  */
 typedef struct GUI_EDITTEXT_t {
     GUI_HANDLE C;                           /*!< GUI handle object, must always be first on list */
+    GUI_OVERLAY_t* Cursor;                  /*!< Text cursor plane, blinks without widget redraw */
 } GUI_EDITTEXT_t;
 #endif /* defined(GUI_INTERNAL) || defined(DOXYGEN) */
 
@@ -40,6 +40,9 @@
 /******************************************************************************/
 #define __GG(x)             ((GUI_GRAPH_t *)(x))
 
+/* Number of plot points converted to screen coordinates before they are drawn */
+#define GRAPH_PLOT_POINTS   32
+
 static
 uint8_t GUI_GRAPH_Callback(GUI_HANDLE_p h, GUI_WC_t ctrl, void* param, void* result);
 
@@ -144,8 +147,9 @@ static GUI_iDim_t tX[GUI_TOUCH_MAX_PRESSES], tY[GUI_TOUCH_MAX_PRESSES];
             
             /* Check if any data attached to this graph */
             if (g->Root.First) {                    /* We have attached plots */
-                GUI_Display_t display;
-                register float x1, y1, x2, y2;      /* Try to add these variables to core registers */
+                register float x1, y1;              /* Try to add these variables to core registers */
+                GUI_DRAW_Poly_t points[GRAPH_PLOT_POINTS];  /* Points of plot on screen */
+                uint32_t cnt;
                 float xSize = g->VisibleMaxX - g->VisibleMinX;  /* Calculate X size */
                 float ySize = g->VisibleMaxY - g->VisibleMinY;  /* Calculate Y size */
                 float xStep = (float)(width - bl - br) / (float)xSize;  /* Calculate X step */
@@ -154,21 +158,8 @@ static GUI_iDim_t tX[GUI_TOUCH_MAX_PRESSES], tY[GUI_TOUCH_MAX_PRESSES];
                 GUI_Dim_t xLeft = x + bl;                   /* Left X position */
                 uint32_t read, write;
                 
-                memcpy(&display, disp, sizeof(GUI_Display_t));  /* Save GUI display data */
-                
-                /* Set clipping region */
-                if ((x + bl) > disp->X1) {
-                    disp->X1 = x + bl;
-                }
-                if ((x + width - br) < disp->X2) {
-                    disp->X2 = x + width - br;
-                }
-                if ((y + bt) > disp->Y1) {
-                    disp->Y1 = y + bt;
-                }
-                if ((y + height - bb) < disp->Y2) {
-                    disp->Y2 = y + height - bb;
-                }
+                /* Limit clipping region to plot area */
+                GUI_DRAW_PushClip(disp, x + bl, y + bt, width - bl - br, height - bt - bb);
                 
                 /* Draw all plot attached to graph */
                 for (link = __GUI_LINKEDLIST_MULTI_GETNEXT_GEN(&g->Root, 0); link; link = __GUI_LINKEDLIST_MULTI_GETNEXT_GEN(0, link)) {
@@ -190,18 +181,30 @@ static GUI_iDim_t tX[GUI_TOUCH_MAX_PRESSES], tY[GUI_TOUCH_MAX_PRESSES];
                             continue;
                         }
                         
+                        points[0].X = x1;
+                        points[0].Y = y1;
+                        cnt = 1;
                         while (read != write && x1 <= disp->X2) {   /* Calculate next points */
-                            x2 = x1 + xStep;                /* Calculate next X */
-                            y2 = yBottom - ((float)data->Data[read] - g->VisibleMinY) * yStep;  /* Calculate next Y */
-                            if ((x1 >= disp->X1 || x2 >= disp->X1) && (x1 < disp->X2 || x2 < disp->X2)) {
-                                GUI_DRAW_Line(disp, x1, y1, x2, y2, data->Color);   /* Draw actual line */
+                            x1 += xStep;            /* Calculate next X */
+                            y1 = yBottom - ((float)data->Data[read] - g->VisibleMinY) * yStep;  /* Calculate next Y */
+                            if (x1 < disp->X1) {    /* Line is left of active area, point is new start */
+                                cnt = 0;
+                            }
+                            points[cnt].X = x1;
+                            points[cnt].Y = y1;
+                            if (++cnt == GRAPH_PLOT_POINTS) {   /* Draw full buffer, last point starts next part */
+                                GUI_DRAW_PolyLineAA(disp, points, cnt, data->Color);
+                                points[0] = points[cnt - 1];
+                                cnt = 1;
                             }
-                            x1 = x2, y1 = y2;       /* Copy values as old */
                             
                             if (++read == data->Length) {   /* Check overflow */
                                 read = 0;
                             }
                         }
+                        if (cnt > 1) {
+                            GUI_DRAW_PolyLineAA(disp, points, cnt, data->Color);    /* Draw remaining lines */
+                        }
                     } else if (data->Type == GUI_GRAPH_TYPE_XY) {   /* Draw XY plot */                        
                         /* Calculate first point */
                         x1 = xLeft + ((float)data->Data[2 * read + 0] - g->VisibleMinX) * xStep;
@@ -210,19 +213,28 @@ static GUI_iDim_t tX[GUI_TOUCH_MAX_PRESSES], tY[GUI_TOUCH_MAX_PRESSES];
                             read = 0;
                         }
                         
+                        points[0].X = x1;
+                        points[0].Y = y1;
+                        cnt = 1;
                         while (read != write) {     /* Calculate next points */
-                            x2 = xLeft + ((float)(data->Data[2 * read + 0] - g->VisibleMinX) * xStep);
-                            y2 = yBottom - ((float)(data->Data[2 * read + 1] - g->VisibleMinY) * yStep);
-                            GUI_DRAW_Line(disp, x1, y1, x2, y2, data->Color);   /* Draw actual line */
-                            x1 = x2, y1 = y2;       /* Check overflow */
+                            points[cnt].X = xLeft + ((float)(data->Data[2 * read + 0] - g->VisibleMinX) * xStep);
+                            points[cnt].Y = yBottom - ((float)(data->Data[2 * read + 1] - g->VisibleMinY) * yStep);
+                            if (++cnt == GRAPH_PLOT_POINTS) {   /* Draw full buffer, last point starts next part */
+                                GUI_DRAW_PolyLineAA(disp, points, cnt, data->Color);
+                                points[0] = points[cnt - 1];
+                                cnt = 1;
+                            }
                             
                             if (++read == data->Length) {   /* Check overflow */
                                 read = 0;
                             }
                         }
+                        if (cnt > 1) {
+                            GUI_DRAW_PolyLineAA(disp, points, cnt, data->Color);    /* Draw remaining lines */
+                        }
                     }
                 }
-                memcpy(disp, &display, sizeof(GUI_Display_t));  /* Copy data back */
+                GUI_DRAW_PopClip(disp);             /* Restore clipping region */
             }
             return 1;
         }
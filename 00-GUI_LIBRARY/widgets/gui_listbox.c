@@ -262,7 +262,6 @@ uint8_t GUI_LISTBOX_Callback(GUI_HANDLE_p h, GUI_WC_t ctrl, void* param, void* r
                 uint16_t yOffset;
                 uint16_t itemHeight;                /* Get item height */
                 uint16_t index = 0;                 /* Start index */
-                GUI_iDim_t tmp;
                 
                 itemHeight = __ItemHeight(h, &yOffset); /* Get item height and Y offset */
                 
@@ -275,10 +274,7 @@ uint8_t GUI_LISTBOX_Callback(GUI_HANDLE_p h, GUI_WC_t ctrl, void* param, void* r
                 f.Align = GUI_HALIGN_LEFT | GUI_VALIGN_CENTER;
                 f.Color1Width = f.Width;
                 
-                tmp = disp->Y2;                     /* Scale out drawing area */
-                if (disp->Y2 > (y + height - 2)) {
-                    disp->Y2 = y + height - 2;
-                }
+                GUI_DRAW_PushClip(disp, x, y, width, height - 2);  /* Scale out drawing area */
                 
                 for (item = (GUI_LISTBOX_ITEM_t *)__GUI_LINKEDLIST_GETNEXT_GEN(&o->Root, NULL); 
                     item && index < o->VisibleStartIndex; 
@@ -298,7 +294,7 @@ uint8_t GUI_LISTBOX_Callback(GUI_HANDLE_p h, GUI_WC_t ctrl, void* param, void* r
                     item = (GUI_LISTBOX_ITEM_t *)__GUI_LINKEDLIST_GETNEXT_GEN(NULL, &item->List);
                     index++;
                 }
-                disp->Y2 = tmp;
+                GUI_DRAW_PopClip(disp);
             }
             
             return 1;
@@ -98,6 +98,9 @@ void __RemoveWidget(GUI_HANDLE_p h) {
     if (__GH(h)->Timer) {                           /* Check timer memory */
         __GUI_TIMER_Remove(&__GH(h)->Timer);        /* Free timer memory */
     }
+    if (__GH(h)->Overlay) {                         /* Check overlay plane */
+        __GUI_OVERLAY_Remove(&__GH(h)->Overlay);    /* Remove plane from screen and free memory */
+    }
     if (__GH(h)->Colors) {                          /* Free allocate colors if exists */
         __GUI_MEMFREE(__GH(h)->Colors);
     }
@@ -144,6 +147,17 @@ void __GUI_WIDGET_SetClippingRegion(GUI_HANDLE_p h) {
     }
 }
 
+/* Get widget shown on overlay plane which is widget itself or one of its parents */
+static
+GUI_HANDLE_p __GetOverlayWidget(GUI_HANDLE_p h) {
+    for (; h; h = __GH(h)->Parent) {
+        if (__GH(h)->Overlay) {
+            return h;
+        }
+    }
+    return 0;
+}
+
 static
 uint8_t __GUI_WIDGET_InvalidatePrivate(GUI_HANDLE_p h, uint8_t setclipping) {
     GUI_HANDLE_p h1, h2;
@@ -158,6 +172,16 @@ uint8_t __GUI_WIDGET_InvalidatePrivate(GUI_HANDLE_p h, uint8_t setclipping) {
     if (__GH(h1)->Flags & GUI_FLAG_IGNORE_INVALIDATE) { /* Check ignore flag */
         return 0;                                   /* Ignore invalidate process */
     }
+    
+    /**
+     * Widget on overlay plane is not drawn on drawing layers
+     * and does not affect widgets below, redraw only overlay widget
+     */
+    h2 = __GetOverlayWidget(h1);
+    if (h2) {
+        __GH(h2)->Flags |= GUI_FLAG_REDRAW;         /* Redraw overlay widget */
+        return 1;
+    }
     __GH(h1)->Flags |= GUI_FLAG_REDRAW;             /* Redraw widget */
     
     if (setclipping) {
@@ -177,6 +201,7 @@ uint8_t __GUI_WIDGET_InvalidatePrivate(GUI_HANDLE_p h, uint8_t setclipping) {
             __GUI_WIDGET_GetLCDAbsPosAndVisibleWidthHeight(h2, &h2x1, &h2y1, &h2x2, &h2y2);
             if (
                 __GH(h2)->Flags & GUI_FLAG_REDRAW ||    /* Bit is already set */
+                __GH(h2)->Overlay ||                /* Overlay plane is not affected */
                 !__GUI_RECT_MATCH(
                     h1x1, h1y1, h1x2, h1y2,
                     h2x1, h2y1, h2x2, h2y2)
@@ -377,7 +402,7 @@ uint8_t __GUI_WIDGET_Invalidate(GUI_HANDLE_p h) {
 
 uint8_t __GUI_WIDGET_InvalidateWithParent(GUI_HANDLE_p h) {
     __GUI_WIDGET_InvalidatePrivate(h, 1);           /* Invalidate object */
-    if (__GH(h)->Parent) {                          /* If parent exists, invalid only parent */
+    if (__GH(h)->Parent && !__GH(h)->Overlay) {     /* If parent exists, invalid only parent */
         __GUI_WIDGET_InvalidatePrivate(__GH(h)->Parent, 0); /* Invalidate parent object */
     }
     return 1;
@@ -693,6 +718,23 @@ uint8_t __GUI_WIDGET_Hide(GUI_HANDLE_p h) {
     return 1;
 }
 
+uint8_t __GUI_WIDGET_SetOverlay(GUI_HANDLE_p h, uint8_t state) {
+    if (state && !__GH(h)->Overlay) {               /* Move widget to overlay plane */
+        if (!GUI.LCD.OverlayLayer || (__GH(h)->Parent && __GH(h)->Parent != GUI_WINDOW_GetDesktop())) {
+            return 0;                               /* Only top widgets can be on overlay plane */
+        }
+        __GUI_WIDGET_InvalidateWithParent(h);       /* Remove widget from drawing layers */
+        __GH(h)->Overlay = __GUI_OVERLAY_Create(0, 0, 0, 0, 0); /* Create plane, position is set on redraw */
+        if (!__GH(h)->Overlay) {
+            return 0;
+        }
+    } else if (!state && __GH(h)->Overlay) {        /* Move widget back to drawing layers */
+        __GUI_OVERLAY_Remove(&__GH(h)->Overlay);    /* Remove plane from screen */
+        __GUI_WIDGET_InvalidateWithParent(h);       /* Draw widget on drawing layers */
+    }
+    return 1;
+}
+
 uint8_t __GUI_WIDGET_ToggleExpanded(GUI_HANDLE_p h) {
     if (__GUI_WIDGET_IsExpanded(h)) {               /* Check current status */
         __GH(h)->Flags &= ~GUI_FLAG_EXPANDED;       /* Clear expanded */
@@ -1043,6 +1085,30 @@ uint8_t GUI_WIDGET_Hide(GUI_HANDLE_p h) {
     return res;
 }
 
+uint8_t GUI_WIDGET_SetOverlay(GUI_HANDLE_p h, uint8_t state) {
+    uint8_t res;
+    __GUI_ASSERTPARAMS(__GUI_WIDGET_IsWidget(h));   /* Check valid parameter */
+    __GUI_ENTER();                                  /* Enter GUI */
+    
+    res = __GUI_WIDGET_SetOverlay(h, state);        /* Set overlay mode */
+    
+    __GUI_LEAVE();                                  /* Leave GUI */
+    return res;
+}
+
+uint8_t GUI_WIDGET_SetOverlayAlpha(GUI_HANDLE_p h, GUI_Byte alpha) {
+    uint8_t res = 0;
+    __GUI_ASSERTPARAMS(__GUI_WIDGET_IsWidget(h));   /* Check valid parameter */
+    __GUI_ENTER();                                  /* Enter GUI */
+    
+    if (__GH(h)->Overlay) {                         /* Alpha is only valid for overlay plane */
+        res = __GUI_OVERLAY_SetAlpha(__GH(h)->Overlay, alpha);
+    }
+    
+    __GUI_LEAVE();                                  /* Leave GUI */
+    return res;
+}
+
 GUI_ID_t GUI_WIDGET_GetId(GUI_HANDLE_p h) {
     __GUI_ASSERTPARAMS(__GUI_WIDGET_IsWidget(h));   /* Check valid parameter */
     return __GUI_WIDGET_GetId(h);                   /* Return widget ID */
@@ -359,6 +359,17 @@ uint8_t __GUI_WIDGET_Show(GUI_HANDLE_p h);
  */
 uint8_t __GUI_WIDGET_Hide(GUI_HANDLE_p h);
 
+/**
+ * \brief           Show widget on overlay plane on top of all other widgets
+ * \note            Since this function is private, it can only be used by user inside GUI library
+ * \note            Only widgets on desktop can be shown on overlay plane
+ * \param[in,out]   h: Widget handle
+ * \param[in]       state: Set to 1 to show widget on overlay plane or 0 to draw it on drawing layers
+ * \retval          1: Overlay mode was set ok
+ * \retval          0: Overlay mode was not set
+ */
+uint8_t __GUI_WIDGET_SetOverlay(GUI_HANDLE_p h, uint8_t state);
+
 /**
  * \brief           Toggle expandend (maximized) mode of widget (mostly of windows)
  * \note            Since this function is private, it can only be used by user inside GUI library
@@ -907,6 +918,29 @@ uint8_t GUI_WIDGET_Hide(GUI_HANDLE_p h);
  */
 uint8_t GUI_WIDGET_PutOnFront(GUI_HANDLE_p h);
 
+/**
+ * \brief           Show widget on overlay plane on top of all other widgets
+ * \note            Widget on overlay plane is moved by changing plane position only,
+ *                     widgets below are not redrawn. Use it for popups, dialogs and similar
+ * \note            Only widgets on desktop can be shown on overlay plane
+ * \param[in,out]   h: Widget handle
+ * \param[in]       state: Set to 1 to show widget on overlay plane or 0 to draw it with other widgets
+ * \retval          1: Overlay mode was set ok
+ * \retval          0: Overlay mode was not set
+ * \sa              GUI_WIDGET_SetOverlayAlpha
+ */
+uint8_t GUI_WIDGET_SetOverlay(GUI_HANDLE_p h, uint8_t state);
+
+/**
+ * \brief           Set transparency of widget shown on overlay plane
+ * \param[in,out]   h: Widget handle
+ * \param[in]       alpha: Plane alpha, 0xFF is opaque and 0x00 is fully transparent
+ * \retval          1: Alpha was set ok
+ * \retval          0: Alpha was not set
+ * \sa              GUI_WIDGET_SetOverlay
+ */
+uint8_t GUI_WIDGET_SetOverlayAlpha(GUI_HANDLE_p h, GUI_Byte alpha);
+
 /**
  * \brief           Invalidate widget object and prepare to new redraw
  * \param[in,out]   h: Widget handle